@@ -0,0 +1,139 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <thread>
+
+namespace las::bench {
+
+    namespace {
+
+        constexpr std::size_t name_width { 40 };
+        constexpr std::size_t column_width { 14 };
+
+        /// percentiles reported for every benchmark measuring latency
+        constexpr double reported_percentiles [] { 0.5, 0.9, 0.99, 0.999 };
+
+    }
+
+    std::size_t bench_config::scaled (std::size_t count) const noexcept {
+        return std::max < std::size_t > (1, static_cast < std::size_t > (std::llround (static_cast < double > (count) * scale)));
+    }
+
+    double bench_report::median_ops_per_sec () const {
+        if (ops_per_sec.empty ()) {
+            return 0.0;
+        }
+
+        auto sorted = ops_per_sec;
+        std::sort (sorted.begin (), sorted.end ());
+
+        auto const MIDDLE = sorted.size () / 2;
+        return sorted.size () % 2 ? sorted [MIDDLE] : (sorted [MIDDLE - 1] + sorted [MIDDLE]) / 2.0;
+    }
+
+    bench_report run_benchmark (benchmark const & bench, bench_config const & config, std::size_t repetitions) {
+        bench_report report { bench.name, {}, {} };
+
+        // warm up caches, allocators and thread creation
+        static_cast < void > (bench.run (config));
+
+        for (std::size_t i = 0; i < repetitions; ++i) {
+            auto const RESULT = bench.run (config);
+            auto const SECONDS = std::chrono::duration < double > (RESULT.elapsed).count ();
+
+            report.ops_per_sec.push_back (SECONDS > 0.0 ? static_cast < double > (RESULT.operations) / SECONDS : 0.0);
+            report.latency.merge (RESULT.latency);
+        }
+
+        return report;
+    }
+
+    void print_header (std::ostream & stream, bench_config const & config, std::size_t repetitions, bool csv) {
+        auto const PREFIX = csv ? "# " : "";
+
+#if defined (NDEBUG)
+        auto const BUILD = "release";
+#else
+        auto const BUILD = "debug";
+#endif
+
+        stream
+            << PREFIX << "las-bench build=" << BUILD
+            << " threads=" << config.thread_count
+            << " scale=" << config.scale
+            << " repetitions=" << repetitions
+            << " hardware_threads=" << std::thread::hardware_concurrency () << '\n';
+
+        if (csv) {
+            stream << "name,ops_per_sec_median,ops_per_sec_min,ops_per_sec_max,p50_ns,p90_ns,p99_ns,p999_ns,max_ns" << '\n';
+            return;
+        }
+
+        stream
+            << std::left << std::setw (name_width) << "benchmark" << std::right
+            << std::setw (column_width) << "ops/s"
+            << std::setw (column_width) << "min ops/s"
+            << std::setw (column_width) << "max ops/s"
+            << std::setw (column_width) << "p50 ns"
+            << std::setw (column_width) << "p90 ns"
+            << std::setw (column_width) << "p99 ns"
+            << std::setw (column_width) << "p99.9 ns"
+            << std::setw (column_width) << "max ns" << '\n';
+    }
+
+    void print_report (std::ostream & stream, bench_report const & report, bool csv) {
+        auto const [MIN_IT, MAX_IT] = std::minmax_element (report.ops_per_sec.begin (), report.ops_per_sec.end ());
+        bool const HAS_LATENCY = report.latency.count () != 0;
+
+        auto const FLAGS = stream.flags ();
+        stream << std::fixed << std::setprecision (0);
+
+        if (csv) {
+            stream << report.name << ',' << report.median_ops_per_sec () << ',' << *MIN_IT << ',' << *MAX_IT;
+
+            for (auto const FRACTION : reported_percentiles) {
+                stream << ',';
+
+                if (HAS_LATENCY) {
+                    stream << report.latency.percentile (FRACTION);
+                }
+            }
+
+            stream << ',';
+
+            if (HAS_LATENCY) {
+                stream << report.latency.max ();
+            }
+        } else {
+            stream
+                << std::left << std::setw (name_width) << report.name << std::right
+                << std::setw (column_width) << report.median_ops_per_sec ()
+                << std::setw (column_width) << *MIN_IT
+                << std::setw (column_width) << *MAX_IT;
+
+            for (auto const FRACTION : reported_percentiles) {
+                stream << std::setw (column_width);
+
+                if (HAS_LATENCY) {
+                    stream << report.latency.percentile (FRACTION);
+                } else {
+                    stream << '-';
+                }
+            }
+
+            stream << std::setw (column_width);
+
+            if (HAS_LATENCY) {
+                stream << report.latency.max ();
+            } else {
+                stream << '-';
+            }
+        }
+
+        stream << '\n';
+        stream.flags (FLAGS);
+    }
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "las/histogram.hpp"
+
+namespace las::bench {
+
+    using clock_type = std::chrono::steady_clock;
+
+    /// workload sizing shared by every benchmark
+    struct bench_config {
+        /// worker and producer count N of the scaled workloads
+        std::size_t thread_count { 2 };
+
+        /// multiplier applied to workload sizes
+        double      scale { 1.0 };
+
+        /// scale a workload size, never below one
+        [[nodiscard]] std::size_t scaled (std::size_t count) const noexcept;
+    };
+
+    /// outcome of a single run
+    struct run_result {
+        /// number of measured operations
+        uint64_t                    operations { 0 };
+
+        /// time spent on the measured operations
+        std::chrono::nanoseconds    elapsed { 0 };
+
+        /// latency of the measured operations in nanoseconds, empty if the benchmark does not measure latency
+        histogram                   latency;
+    };
+
+    /// named workload, runs once per call
+    struct benchmark {
+        std::string                                         name;
+        std::function < run_result (bench_config const &) > run;
+    };
+
+    /// aggregate of the measured runs of a benchmark
+    struct bench_report {
+        std::string             name;
+
+        /// operations per second of each run
+        std::vector < double >  ops_per_sec;
+
+        /// latency of every run
+        histogram               latency;
+
+        [[nodiscard]] double median_ops_per_sec () const;
+    };
+
+    /// add the sync_dispatcher and async_dispatcher workloads
+    void add_dispatcher_benchmarks (std::vector < benchmark > & benchmarks, bench_config const & config);
+
+    /// run a benchmark once to warm up, then measure it
+    /// \param bench benchmark to run
+    /// \param config workload sizing
+    /// \param repetitions number of measured runs
+    bench_report run_benchmark (benchmark const & bench, bench_config const & config, std::size_t repetitions);
+
+    void print_header (std::ostream & stream, bench_config const & config, std::size_t repetitions, bool csv);
+
+    void print_report (std::ostream & stream, bench_report const & report, bool csv);
+
+    /// spin until a condition holds, yielding between checks
+    template < typename predicate_t >
+    void wait_until (predicate_t && predicate) {
+        while (!predicate ()) {
+            std::this_thread::yield ();
+        }
+    }
+
+}
+
+#endif //BENCH_HPP
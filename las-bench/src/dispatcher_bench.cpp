@@ -0,0 +1,378 @@
+#include "bench.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "las/dispatcher.hpp"
+#include "las/spin_mutex.hpp"
+
+namespace las::bench {
+
+    namespace {
+
+        /// tasks per run of the throughput and enqueue latency workloads
+        constexpr std::size_t task_count { 1000000 };
+
+        /// tasks per fan out round
+        constexpr std::size_t fan_width { 64 };
+
+        /// fan out rounds per run
+        constexpr std::size_t fan_rounds { 10000 };
+
+        /// round trips per ping pong run
+        constexpr std::size_t exchange_count { 100000 };
+
+        /// one in latency_sample_rate tasks records its latency
+        constexpr std::size_t latency_sample_rate { 64 };
+
+        std::chrono::nanoseconds elapsed_since (clock_type::time_point start) {
+            return std::chrono::duration_cast < std::chrono::nanoseconds > (clock_type::now () - start);
+        }
+
+        /// histogram shared by consumer threads
+        class latency_sampler {
+        public:
+            void record (std::chrono::nanoseconds latency) {
+                std::unique_lock const LOCK (_lock);
+                _latency.record (latency);
+            }
+
+            [[nodiscard]] histogram take () {
+                std::unique_lock const LOCK (_lock);
+                return _latency;
+            }
+
+        private:
+            spin_mutex  _lock;
+            histogram   _latency;
+        };
+
+        std::unique_ptr < async_dispatcher > make_async (std::size_t thread_count, async_dispatch_mode mode) {
+            async_dispatcher_options options;
+
+            options.thread_count = thread_count;
+            options.mode = mode;
+
+            return std::make_unique < async_dispatcher > (options);
+        }
+
+        /// dispatch a sync dispatcher on the calling thread until a flag is set
+        void dispatch_until (sync_dispatcher & dispatcher, std::atomic_bool const & done) {
+            while (!done.load (std::memory_order_acquire)) {
+                if (dispatcher.drain () == 0) {
+                    std::this_thread::yield ();
+                }
+            }
+        }
+
+        run_result sync_throughput (bench_config const & config) {
+            auto const COUNT = config.scaled (task_count);
+
+            sync_dispatcher dispatcher;
+            run_result result { COUNT, {}, {} };
+
+            auto const START = clock_type::now ();
+
+            for (std::size_t i = 0; i < COUNT; ++i) {
+                dispatcher.post ([]() {});
+            }
+
+            dispatcher.drain ();
+
+            result.elapsed = elapsed_since (START);
+            return result;
+        }
+
+        run_result async_throughput (bench_config const & config, async_dispatch_mode mode) {
+            auto const COUNT = config.scaled (task_count);
+
+            auto dispatcher = make_async (config.thread_count, mode);
+            std::atomic_size_t executed { 0 };
+            run_result result { COUNT, {}, {} };
+
+            auto const START = clock_type::now ();
+
+            for (std::size_t i = 0; i < COUNT; ++i) {
+                dispatcher->post ([&executed]() { executed.fetch_add (1, std::memory_order_relaxed); });
+            }
+
+            wait_until ([&]() { return executed.load (std::memory_order_relaxed) == COUNT; });
+
+            result.elapsed = elapsed_since (START);
+            return result;
+        }
+
+        /// time every post, tasks are drained between batches on sync dispatchers
+        run_result enqueue_latency (dispatcher & target, std::size_t count, std::function < void () > const & drain) {
+            std::size_t const BATCH_SIZE { 1024 };
+            run_result result { count, {}, {} };
+
+            for (std::size_t i = 0; i < count; ++i) {
+                auto const START = clock_type::now ();
+                target.post ([]() {});
+                auto const LATENCY = elapsed_since (START);
+
+                result.elapsed += LATENCY;
+                result.latency.record (LATENCY);
+
+                if ((i + 1) % BATCH_SIZE == 0) {
+                    drain ();
+                }
+            }
+
+            drain ();
+            return result;
+        }
+
+        run_result sync_enqueue_latency (bench_config const & config) {
+            sync_dispatcher dispatcher;
+            return enqueue_latency (dispatcher, config.scaled (task_count), [&dispatcher]() { dispatcher.drain (); });
+        }
+
+        run_result async_enqueue_latency (bench_config const & config) {
+            auto dispatcher = make_async (config.thread_count, async_dispatch_mode::shared_queue);
+            return enqueue_latency (*dispatcher, config.scaled (task_count), []() {});
+        }
+
+        /// a root task posts fan_width tasks, the last one to complete starts the next round
+        struct fan_state {
+            fan_state (dispatcher & target_v, std::size_t rounds) :
+                target { target_v },
+                rounds_left { rounds }
+            {}
+
+            dispatcher &                target;
+            std::size_t                 rounds_left;
+            std::atomic_size_t          pending { 0 };
+            clock_type::time_point      round_start {};
+            histogram                   latency;
+            std::atomic_bool            done { false };
+        };
+
+        void fan_out (fan_state & state);
+
+        void fan_in (fan_state & state) {
+            if (state.pending.fetch_sub (1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+
+            state.latency.record (elapsed_since (state.round_start));
+
+            if (--state.rounds_left == 0) {
+                state.done.store (true, std::memory_order_release);
+                return;
+            }
+
+            state.target.post ([&state]() { fan_out (state); });
+        }
+
+        void fan_out (fan_state & state) {
+            state.round_start = clock_type::now ();
+            state.pending.store (fan_width, std::memory_order_relaxed);
+
+            for (std::size_t i = 0; i < fan_width; ++i) {
+                state.target.post ([&state]() { fan_in (state); });
+            }
+        }
+
+        run_result sync_fan_out_in (bench_config const & config) {
+            sync_dispatcher dispatcher;
+            fan_state state (dispatcher, config.scaled (fan_rounds));
+
+            auto const ROUNDS = state.rounds_left;
+            auto const START = clock_type::now ();
+
+            dispatcher.post ([&state]() { fan_out (state); });
+            dispatch_until (dispatcher, state.done);
+
+            return { ROUNDS * fan_width, elapsed_since (START), state.latency };
+        }
+
+        run_result async_fan_out_in (bench_config const & config, async_dispatch_mode mode) {
+            auto dispatcher = make_async (config.thread_count, mode);
+            fan_state state (*dispatcher, config.scaled (fan_rounds));
+
+            auto const ROUNDS = state.rounds_left;
+            auto const START = clock_type::now ();
+
+            dispatcher->post ([&state]() { fan_out (state); });
+            wait_until ([&]() { return state.done.load (std::memory_order_acquire); });
+
+            return { ROUNDS * fan_width, elapsed_since (START), state.latency };
+        }
+
+        /// producer threads post task_count tasks in total, sampling the time from post to execution
+        run_result producer_consumer (dispatcher & target, std::size_t producer_count, std::size_t count, std::function < void (std::atomic_bool const &) > const & consume) {
+            std::atomic_size_t executed { 0 };
+            std::atomic_bool go { false };
+            std::atomic_bool done { false };
+            latency_sampler sampler;
+
+            std::vector < std::thread > producers;
+
+            for (std::size_t p = 0; p < producer_count; ++p) {
+                producers.emplace_back ([&, p]() {
+                    auto const BEGIN = count * p / producer_count;
+                    auto const END = count * (p + 1) / producer_count;
+
+                    wait_until ([&]() { return go.load (std::memory_order_acquire); });
+
+                    for (auto i = BEGIN; i < END; ++i) {
+                        if (i % latency_sample_rate == 0) {
+                            target.post ([&, POSTED = clock_type::now ()]() {
+                                sampler.record (elapsed_since (POSTED));
+                                executed.fetch_add (1, std::memory_order_relaxed);
+                            });
+                        } else {
+                            target.post ([&executed]() { executed.fetch_add (1, std::memory_order_relaxed); });
+                        }
+                    }
+                });
+            }
+
+            std::thread watcher ([&]() {
+                wait_until ([&]() { return executed.load (std::memory_order_relaxed) == count; });
+                done.store (true, std::memory_order_release);
+            });
+
+            auto const START = clock_type::now ();
+            go.store (true, std::memory_order_release);
+
+            consume (done);
+            watcher.join ();
+
+            auto const ELAPSED = elapsed_since (START);
+
+            for (auto & producer : producers) {
+                producer.join ();
+            }
+
+            return { count, ELAPSED, sampler.take () };
+        }
+
+        run_result sync_producer_consumer (bench_config const & config, std::size_t producer_count) {
+            sync_dispatcher dispatcher;
+
+            return producer_consumer (dispatcher, producer_count, config.scaled (task_count), [&dispatcher](std::atomic_bool const & done) {
+                dispatch_until (dispatcher, done);
+            });
+        }
+
+        run_result async_producer_consumer (bench_config const & config, std::size_t producer_count, std::size_t consumer_count) {
+            auto dispatcher = make_async (consumer_count, async_dispatch_mode::shared_queue);
+
+            return producer_consumer (*dispatcher, producer_count, config.scaled (task_count), [](std::atomic_bool const & done) {
+                wait_until ([&]() { return done.load (std::memory_order_acquire); });
+            });
+        }
+
+        /// a task bounces between two dispatchers, the ping side records every round trip
+        struct ping_state {
+            ping_state (dispatcher & ping_end_v, dispatcher & pong_end_v, std::size_t exchanges) :
+                ping_end { ping_end_v },
+                pong_end { pong_end_v },
+                remaining { exchanges }
+            {}
+
+            dispatcher &                ping_end;
+            dispatcher &                pong_end;
+            std::size_t                 remaining;
+            clock_type::time_point      sent {};
+            histogram                   latency;
+            std::atomic_bool            done { false };
+        };
+
+        void pong (ping_state & state);
+
+        void ping (ping_state & state) {
+            auto const NOW = clock_type::now ();
+
+            if (state.sent != clock_type::time_point {}) {
+                state.latency.record (std::chrono::duration_cast < std::chrono::nanoseconds > (NOW - state.sent));
+            }
+
+            if (state.remaining == 0) {
+                state.done.store (true, std::memory_order_release);
+                return;
+            }
+
+            --state.remaining;
+            state.sent = NOW;
+            state.pong_end.post ([&state]() { pong (state); });
+        }
+
+        void pong (ping_state & state) {
+            state.ping_end.post ([&state]() { ping (state); });
+        }
+
+        run_result sync_ping_pong (bench_config const & config) {
+            sync_dispatcher ping_end;
+            sync_dispatcher pong_end;
+            ping_state state (ping_end, pong_end, config.scaled (exchange_count));
+
+            auto const EXCHANGES = state.remaining;
+
+            std::thread pong_thread ([&]() { dispatch_until (pong_end, state.done); });
+
+            auto const START = clock_type::now ();
+
+            ping_end.post ([&state]() { ping (state); });
+            dispatch_until (ping_end, state.done);
+
+            auto const ELAPSED = elapsed_since (START);
+            pong_thread.join ();
+
+            return { EXCHANGES, ELAPSED, state.latency };
+        }
+
+        run_result async_ping_pong (bench_config const & config) {
+            auto ping_end = make_async (1, async_dispatch_mode::shared_queue);
+            auto pong_end = make_async (1, async_dispatch_mode::shared_queue);
+            ping_state state (*ping_end, *pong_end, config.scaled (exchange_count));
+
+            auto const EXCHANGES = state.remaining;
+            auto const START = clock_type::now ();
+
+            ping_end->post ([&state]() { ping (state); });
+            wait_until ([&]() { return state.done.load (std::memory_order_acquire); });
+
+            return { EXCHANGES, elapsed_since (START), state.latency };
+        }
+
+    }
+
+    void add_dispatcher_benchmarks (std::vector < benchmark > & benchmarks, bench_config const & config) {
+        auto const N = config.thread_count;
+        auto const RATIO = [](std::size_t producers, std::size_t consumers) {
+            return std::to_string (producers) + ":" + std::to_string (consumers);
+        };
+
+        benchmarks.push_back ({ "sync/empty_task_throughput", sync_throughput });
+        benchmarks.push_back ({ "sync/enqueue_latency", sync_enqueue_latency });
+        benchmarks.push_back ({ "sync/fan_out_in", sync_fan_out_in });
+        benchmarks.push_back ({ "sync/producer_consumer/1:1", [](bench_config const & cfg) { return sync_producer_consumer (cfg, 1); } });
+        benchmarks.push_back ({ "sync/producer_consumer/" + RATIO (N, 1), [N](bench_config const & cfg) { return sync_producer_consumer (cfg, N); } });
+        benchmarks.push_back ({ "sync/ping_pong", sync_ping_pong });
+
+        for (auto const MODE : { async_dispatch_mode::shared_queue, async_dispatch_mode::work_stealing }) {
+            std::string const PREFIX = MODE == async_dispatch_mode::shared_queue ? "async/" : "async_work_stealing/";
+
+            benchmarks.push_back ({ PREFIX + "empty_task_throughput", [MODE](bench_config const & cfg) { return async_throughput (cfg, MODE); } });
+            benchmarks.push_back ({ PREFIX + "fan_out_in", [MODE](bench_config const & cfg) { return async_fan_out_in (cfg, MODE); } });
+        }
+
+        benchmarks.push_back ({ "async/enqueue_latency", async_enqueue_latency });
+
+        for (auto const & [PRODUCERS, CONSUMERS] : { std::pair { std::size_t { 1 }, std::size_t { 1 } }, std::pair { std::size_t { 1 }, N }, std::pair { N, std::size_t { 1 } }, std::pair { N, N } }) {
+            benchmarks.push_back ({
+                "async/producer_consumer/" + RATIO (PRODUCERS, CONSUMERS),
+                [PRODUCERS = PRODUCERS, CONSUMERS = CONSUMERS](bench_config const & cfg) { return async_producer_consumer (cfg, PRODUCERS, CONSUMERS); }
+            });
+        }
+
+        benchmarks.push_back ({ "async/ping_pong", async_ping_pong });
+    }
+
+}
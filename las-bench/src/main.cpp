@@ -0,0 +1,52 @@
+#include <iostream>
+
+#include "bench.hpp"
+#include "options.hpp"
+
+int main (int arg_c, char ** arg_v) {
+    using namespace las::bench;
+
+    options opts;
+
+    try {
+        opts = options::parse (arg_c, arg_v);
+    } catch (std::exception & ex) {
+        std::cerr << "Invalid command line arguments: " << ex.what ()
+            << std::endl
+            << std::endl;
+
+        options::print_help (std::cout);
+        return 1;
+    }
+
+    if (opts.show_help) {
+        options::print_help (std::cout);
+        return 0;
+    }
+
+    bench_config const CONFIG { opts.thread_count, opts.scale };
+
+    std::vector < benchmark > benchmarks;
+    add_dispatcher_benchmarks (benchmarks, CONFIG);
+
+    if (opts.list) {
+        for (auto const & bench : benchmarks) {
+            std::cout << bench.name << '\n';
+        }
+
+        return 0;
+    }
+
+    print_header (std::cout, CONFIG, opts.repetitions, opts.csv);
+
+    for (auto const & bench : benchmarks) {
+        if (bench.name.find (opts.filter) == std::string::npos) {
+            continue;
+        }
+
+        print_report (std::cout, run_benchmark (bench, CONFIG, opts.repetitions), opts.csv);
+        std::cout.flush ();
+    }
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "options.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace las::bench {
+
+    namespace {
+
+        /// value following an option, throws if missing
+        std::string next_value (int & index, int arg_c, char ** arg_v) {
+            if (index + 1 >= arg_c) {
+                throw std::invalid_argument (std::string ("Missing value for ") + arg_v [index]);
+            }
+
+            return arg_v [++index];
+        }
+
+    }
+
+    void options::print_help (std::ostream & stream) {
+        stream
+            << "Dispatcher micro benchmarks" << '\n'
+            << "Usage: las-bench [options]" << '\n'
+            << '\n'
+            << "  -f, --filter arg       Run benchmarks whose name contains arg" << '\n'
+            << "  -r, --repetitions arg  Measured runs per benchmark, after one warm up run (default: 5)" << '\n'
+            << "  -t, --threads arg      Worker and producer count N (default: half the hardware threads, at least 2)" << '\n'
+            << "  -s, --scale arg        Multiplier applied to every workload size (default: 1.0)" << '\n'
+            << "      --csv              Print results as comma separated values" << '\n'
+            << "  -l, --list             List benchmark names and exit" << '\n'
+            << "  -h, --help             Print Help" << '\n';
+    }
+
+    options options::parse (int arg_c, char ** arg_v) {
+        options opts;
+
+        for (int i = 1; i < arg_c; ++i) {
+            std::string const ARG { arg_v [i] };
+
+            if (ARG == "-f" || ARG == "--filter") {
+                opts.filter = next_value (i, arg_c, arg_v);
+            } else if (ARG == "-r" || ARG == "--repetitions") {
+                opts.repetitions = std::stoul (next_value (i, arg_c, arg_v));
+            } else if (ARG == "-t" || ARG == "--threads") {
+                opts.thread_count = std::stoul (next_value (i, arg_c, arg_v));
+            } else if (ARG == "-s" || ARG == "--scale") {
+                opts.scale = std::stod (next_value (i, arg_c, arg_v));
+            } else if (ARG == "--csv") {
+                opts.csv = true;
+            } else if (ARG == "-l" || ARG == "--list") {
+                opts.list = true;
+            } else if (ARG == "-h" || ARG == "--help") {
+                opts.show_help = true;
+            } else {
+                throw std::invalid_argument ("Unknown option " + ARG);
+            }
+        }
+
+        if (opts.repetitions == 0) {
+            throw std::invalid_argument ("Repetitions must be at least 1");
+        }
+
+        if (opts.scale <= 0.0) {
+            throw std::invalid_argument ("Scale must be positive");
+        }
+
+        // fixed default so results stay comparable on the same machine
+        if (opts.thread_count == 0) {
+            opts.thread_count = std::max < std::size_t > (2, std::thread::hardware_concurrency () / 2);
+        }
+
+        return opts;
+    }
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace las::bench {
+
+    struct options {
+
+        static void print_help (std::ostream & stream);
+
+        static options parse (int arg_c, char ** arg_v);
+
+        std::string filter;
+        std::size_t repetitions { 5 };
+        std::size_t thread_count { 0 };
+        double      scale { 1.0 };
+        bool        csv { false };
+        bool        list { false };
+        bool        show_help { false };
+    };
+
+}
+
+#endif //OPTIONS_HPP
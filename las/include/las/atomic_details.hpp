@@ -22,15 +22,16 @@ namespace las::atomic_details {
     template < typename type >
     constexpr bool is_stack_node_v = is_stack_node < type >::value;
 
-	/// compare and swap with acquire and relaxed memory order
+	/// compare and swap with acquire-release and relaxed memory order
 	/// \tparam type the type of the atomic variable
 	/// \param target the atomic variable to compare and swap
 	/// \param expected the expected value
 	/// \param desired the desired value
 	/// \return true if the compare and swap was successful, false otherwise
+	/// \note release publishes pushed nodes, acquire makes popped nodes visible
 	template < typename type >
 	bool compare_and_swap (std::atomic < type > & target, type & expected, type desired) {
-		return target.compare_exchange_weak (expected, desired, std::memory_order_acquire, std::memory_order_relaxed);
+		return target.compare_exchange_weak (expected, desired, std::memory_order_acq_rel, std::memory_order_relaxed);
 	}
 
 	/// hooks a node to the head of a linked list
@@ -135,7 +136,7 @@ namespace las::atomic_details {
 	/// \return the full linked list now derreferenced from the head
 	template < typename node_type >
 	node_type * atomic_detach (std::atomic < node_type * > & head) {
-		return head.exchange (nullptr, std::memory_order_relaxed);
+		return head.exchange (nullptr, std::memory_order_acquire);
 	}
 
 	/// find the tail of a chain
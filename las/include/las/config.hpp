@@ -44,6 +44,11 @@
 #       define LAS_LITTLE_ENDIAN 1
 #endif
 
+// Detect language features
+#if defined (__cpp_impl_coroutine) && __has_include (<coroutine>)
+#       define LAS_HAS_COROUTINES 1
+#endif
+
 namespace las {
 
     enum struct os : uint8_t {
@@ -3,15 +3,46 @@
 #define LAS_DISPATCHER_HPP
 
 #include "las/details.hpp"
+#include "las/dispatcher_metrics.hpp"
+#include "las/event_count.hpp"
 #include "las/locked_value.hpp"
+#include "las/ring_buffer.hpp"
+#include "las/spin_mutex.hpp"
+#include "las/system.hpp"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <future>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <queue>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace las {
 
+    namespace details {
+        struct task_node;
+    }
+
+    /// task scheduling priority
+    enum struct task_priority : uint8_t {
+        high = 0,   ///< latency sensitive tasks, executed before any other pending task
+        normal,     ///< default priority
+        background  ///< bulk tasks, executed when no other task is pending
+    };
+
+    /// number of task priority levels
+    constexpr std::size_t task_priority_count { 3 };
+
     /// task dispatcher abstract class
     class dispatcher : public no_copy {
     public:
@@ -32,109 +63,734 @@ namespace las {
             enqueue_task(task_proxy::make (std::move(package)));
         }
 
-    protected:
+        /// Post a task to be executed without tracking its result
+        /// \tparam func_t callable type
+        /// \tparam args_t arguments type vector
+        /// \param func callable object
+        /// \param args arguments, stored by value and passed to the callable as lvalues
+        /// \note the callable is stored directly, no future state is created. Exceptions escaping
+        /// the callable are not captured and propagate to the executing thread
+        template < typename func_t, typename ... args_t >
+        void post (func_t && func, args_t && ... args)
+        {
+            enqueue_task(make_task (std::forward < func_t > (func), std::forward < args_t > (args)...));
+        }
+
+        /// Post a task to be executed with a given priority without tracking its result
+        /// \tparam func_t callable type
+        /// \tparam args_t arguments type vector
+        /// \param priority task scheduling priority
+        /// \param func callable object
+        /// \param args arguments, stored by value and passed to the callable as lvalues
+        /// \note dispatchers without priority support execute the task as a normal task
+        template < typename func_t, typename ... args_t >
+        void post (task_priority priority, func_t && func, args_t && ... args)
+        {
+            enqueue_priority_task(make_task (std::forward < func_t > (func), std::forward < args_t > (args)...), priority);
+        }
+
+        /// Post a batch of tasks to be executed without tracking their results
+        /// \tparam iterator_t callable iterator type
+        /// \param begin_it first callable in the batch
+        /// \param end_it end of the batch
+        /// \note callables are invoked without arguments. They are copied from the range, use a move iterator to
+        /// move them instead. The whole batch is enqueued at once
+        template < typename iterator_t >
+        void post_bulk (iterator_t begin_it, iterator_t end_it)
+        {
+            std::vector < task_proxy > batch;
+
+            if constexpr (std::is_base_of_v < std::forward_iterator_tag, typename std::iterator_traits < iterator_t >::iterator_category >) {
+                batch.reserve (static_cast < std::size_t > (std::distance (begin_it, end_it)));
+            }
+
+            for (; begin_it != end_it; ++begin_it) {
+                batch.emplace_back (task_proxy::make (*begin_it));
+            }
+
+            if (!batch.empty ()) {
+                enqueue_tasks (batch.data (), batch.size ());
+            }
+        }
+
+        /// Submit a task to be executed and track its result
+        /// \tparam func_t callable type
+        /// \tparam args_t arguments type vector
+        /// \param func callable object
+        /// \param args arguments
+        /// \return future for the callable's result or exception
+        /// \note waiting on the future of a task submitted to a sync_dispatcher, from the dispatching thread, before
+        /// dispatch is called will never complete
+        template < typename func_t, typename ... args_t >
+        [[nodiscard]] auto submit (func_t && func, args_t && ... args)
+        {
+            auto package = std::packaged_task < std::invoke_result_t < std::decay_t < func_t >, std::decay_t < args_t > &... > () > (
+                    std::bind (std::forward < func_t > (func), std::forward < args_t > (args)...)
+            );
+
+            auto future = package.get_future ();
+            enqueue_task(task_proxy::make (std::move(package)));
+
+            return future;
+        }
+
+        /// Submit a task to be executed with a given priority and track its result
+        /// \tparam func_t callable type
+        /// \tparam args_t arguments type vector
+        /// \param priority task scheduling priority
+        /// \param func callable object
+        /// \param args arguments
+        /// \return future for the callable's result or exception
+        template < typename func_t, typename ... args_t >
+        [[nodiscard]] auto submit (task_priority priority, func_t && func, args_t && ... args)
+        {
+            auto package = std::packaged_task < std::invoke_result_t < std::decay_t < func_t >, std::decay_t < args_t > &... > () > (
+                    std::bind (std::forward < func_t > (func), std::forward < args_t > (args)...)
+            );
+
+            auto future = package.get_future ();
+            enqueue_priority_task(task_proxy::make (std::move(package)), priority);
+
+            return future;
+        }
+
+        /// Number of threads executing tasks concurrently
+        /// \note used as a hint to split parallel work
+        [[nodiscard]] virtual std::size_t concurrency () const noexcept {
+            return 1;
+        }
+
+        /// Execute one pending task on the calling thread
+        /// \return true if a task was executed, false if no task was available
+        /// \note used by waiting threads to help instead of blocking
+        virtual bool try_dispatch_one () {
+            return false;
+        }
+
+        /// Check if the calling thread may help through try_dispatch_one while waiting
+        /// \note false where executing a task would move it off the threads it is meant for
+        [[nodiscard]] virtual bool can_help_dispatch () const noexcept {
+            return true;
+        }
+
+        /// Start recording task metrics
+        /// \note metrics are opt-in and stay enabled for the dispatcher's lifetime. Tasks enqueued before are not
+        /// recorded. Each recorded task costs a few clock reads and, when stored inline, a pooled node
+        void enable_metrics ();
 
-        class task_proxy : no_copy {
+        /// check if task metrics are being recorded
+        [[nodiscard]] bool metrics_enabled () const noexcept {
+            return _metrics.load (std::memory_order_acquire) != nullptr;
+        }
+
+        /// Collect the recorded task metrics
+        /// \return snapshot of the metrics, empty if metrics are not enabled
+        [[nodiscard]] dispatcher_metrics_snapshot metrics () const;
+
+        /// Awaitable resuming the awaiting coroutine on a dispatcher thread
+        class schedule_awaitable {
+        public:
+            schedule_awaitable (dispatcher & owner, task_priority priority) noexcept :
+                _owner { owner },
+                _priority { priority }
+            {}
+
+            [[nodiscard]] constexpr bool await_ready () const noexcept {
+                return false;
+            }
+
+            /// post the resumption of the coroutine
+            /// \tparam handle_t coroutine handle type
+            /// \param handle suspended coroutine
+            /// \note the handle fits the task inline storage, nothing is allocated
+            template < typename handle_t >
+            void await_suspend (handle_t handle) {
+                _owner.post (_priority, [handle] () mutable { handle.resume (); });
+            }
+
+            constexpr void await_resume () const noexcept {}
+
+        private:
+            dispatcher &    _owner;
+            task_priority   _priority;
+        };
+
+        /// Resume the awaiting coroutine on a thread of this dispatcher
+        /// \param priority scheduling priority of the resumption
+        /// \return awaitable, used as `co_await dispatcher.schedule ()`
+        /// \note on a sync_dispatcher the coroutine resumes when dispatch is called
+        [[nodiscard]] schedule_awaitable schedule (task_priority priority = task_priority::normal) noexcept {
+            return { *this, priority };
+        }
+
+        /// Type erased task with inline storage for small callables
+        /// \note callables that do not fit the inline storage, or that are not nothrow move constructible,
+        /// are stored in the heap
+        class task_proxy {
         public:
-            virtual ~task_proxy() = default;
+            /// inline storage size, includes the handle's virtual table pointer
+            static constexpr std::size_t inline_capacity { 56 };
 
             class task_handle_base {
             public:
                 virtual ~task_handle_base () = default;
                 virtual void invoke () = 0;
+
+                /// move construct the handle into destination storage and destroy the origin
+                /// \param destination storage to move into
+                /// \return the relocated handle
+                virtual task_handle_base * relocate (void * destination) noexcept = 0;
             };
 
+            /// handle storing the callable inline
             template < class ft_t >
-            class task_handle : public ft_t, public task_handle_base {
+            class task_handle final : public task_handle_base {
             public:
-                explicit task_handle (ft_t && origin) :
-                        ft_t (std::forward < ft_t > (origin))
+                template < typename origin_t >
+                explicit task_handle (origin_t && origin) :
+                        callable (std::forward < origin_t > (origin))
                 {}
 
                 void invoke () override {
-                    std::invoke(*this);
+                    std::invoke(callable);
+                }
+
+                task_handle_base * relocate (void * destination) noexcept override {
+                    auto * moved = ::new (destination) task_handle (std::move (callable));
+                    this->~task_handle ();
+                    return moved;
                 }
+
+                ft_t callable;
+            };
+
+            /// handle storing the callable in the heap
+            template < class ft_t >
+            class task_heap_handle final : public task_handle_base {
+            public:
+                explicit task_heap_handle (std::unique_ptr < ft_t > && origin) noexcept :
+                        callable (std::move (origin))
+                {}
+
+                void invoke () override {
+                    std::invoke(*callable);
+                }
+
+                task_handle_base * relocate (void * destination) noexcept override {
+                    auto * moved = ::new (destination) task_heap_handle (std::move (callable));
+                    this->~task_heap_handle ();
+                    return moved;
+                }
+
+                std::unique_ptr < ft_t > callable;
             };
 
+            /// checks if a callable type is stored inline
+            template < typename ft_t >
+            static constexpr bool is_inline_v =
+                    sizeof (task_handle < ft_t >) <= inline_capacity &&
+                    alignof (task_handle < ft_t >) <= alignof (task_handle_base *) &&
+                    std::is_nothrow_move_constructible_v < ft_t >;
+
             task_proxy() = default;
-            explicit task_proxy(std::unique_ptr < task_handle_base > && handle) :
-                    handle { std::move (handle) }
-            {}
 
-            task_proxy(task_proxy && other) noexcept { this->swap (other); }
+            task_proxy(task_proxy && other) noexcept {
+                move_from (other);
+            }
 
             task_proxy & operator = (task_proxy && other) noexcept {
-                this->swap (other);
+                if (this != &other) {
+                    reset ();
+                    move_from (other);
+                }
+
                 return *this;
             }
 
+            task_proxy (task_proxy const &) = delete;
+            task_proxy & operator = (task_proxy const &) = delete;
+
+            ~task_proxy () {
+                reset ();
+            }
+
             void invoke () const {
-                if (handle) {
-                    handle->invoke();
+                if (_handle) {
+                    _handle->invoke();
+                }
+            }
+
+            /// destroy the stored callable
+            void reset () noexcept {
+                if (_handle) {
+                    _handle->~task_handle_base ();
+                    _handle = nullptr;
                 }
             }
 
             void swap (task_proxy & other) noexcept {
-                std::swap (handle, other.handle);
+                task_proxy temp { std::move (other) };
+                other = std::move (*this);
+                *this = std::move (temp);
             }
 
-            std::unique_ptr < task_handle_base > handle;
+            explicit operator bool () const noexcept {
+                return _handle != nullptr;
+            }
 
-            template < typename return_t >
-            static task_proxy make (std::packaged_task < return_t () > && package) {
-                return task_proxy {
-                    std::make_unique < task_handle <
-                            std::packaged_task < return_t () > > > (
-                            std::move(package))};
+            /// make a task from a callable object
+            /// \param func callable object without arguments
+            template < typename func_t >
+            static task_proxy make (func_t && func) {
+                using ft_t = std::decay_t < func_t >;
+
+                task_proxy proxy;
+
+                if constexpr (is_inline_v < ft_t >) {
+                    proxy._handle = ::new (static_cast < void * > (proxy._storage)) task_handle < ft_t > (
+                            std::forward < func_t > (func));
+                } else {
+                    proxy._handle = ::new (static_cast < void * > (proxy._storage)) task_heap_handle < ft_t > (
+                            std::make_unique < ft_t > (std::forward < func_t > (func)));
+                }
+
+                return proxy;
             }
+
+        private:
+
+            void move_from (task_proxy & other) noexcept {
+                if (other._handle) {
+                    _handle = other._handle->relocate (static_cast < void * > (_storage));
+                    other._handle = nullptr;
+                }
+            }
+
+            alignas (task_handle_base *) std::byte _storage [inline_capacity] {};
+            task_handle_base * _handle { nullptr };
         };
 
+    protected:
+
+        /// Make a task from a callable and its arguments
+        /// \note an already made task_proxy without arguments is passed through as is
+        template < typename func_t, typename ... args_t >
+        static task_proxy make_task (func_t && func, args_t && ... args) {
+            if constexpr (sizeof... (args_t) == 0 && std::is_same_v < std::decay_t < func_t >, task_proxy >) {
+                return task_proxy { std::forward < func_t > (func) };
+            } else if constexpr (sizeof... (args_t) == 0) {
+                return task_proxy::make (std::forward < func_t > (func));
+            } else {
+                return task_proxy::make (
+                        [call = std::forward < func_t > (func),
+                         call_args = std::make_tuple (std::forward < args_t > (args)...)]() mutable {
+                            std::apply (call, call_args);
+                        });
+            }
+        }
+
+        /// Wrap a task to record its metrics, if metrics are enabled
+        /// \param proxy task to wrap, replaced by the wrapper
+        /// \note to be called by implementations for every enqueued task
+        void instrument (task_proxy & proxy) {
+            if (auto * metrics = metrics_recorder ()) {
+                instrument (*metrics, proxy);
+            }
+        }
+
+        /// metrics being recorded, nullptr if metrics are not enabled
+        [[nodiscard]] dispatcher_metrics * metrics_recorder () const noexcept {
+            return _metrics.load (std::memory_order_acquire);
+        }
+
+        /// add implementation specific values to a metrics snapshot
+        /// \param snapshot snapshot being collected
+        virtual void collect_metrics (dispatcher_metrics_snapshot & snapshot) const {
+            (void)snapshot;
+        }
+
         /// Enqueue a task to be executed
         /// \param proxy task to be executed
         virtual void enqueue_task (task_proxy && proxy) = 0;
+
+        /// Enqueue a task to be executed with a given priority
+        /// \param proxy task to be executed
+        /// \param priority task scheduling priority
+        /// \note default implementation ignores the priority
+        virtual void enqueue_priority_task (task_proxy && proxy, task_priority priority) {
+            (void)priority;
+            enqueue_task (std::move (proxy));
+        }
+
+        /// Enqueue a batch of tasks to be executed
+        /// \param tasks first task of the batch, tasks are moved from
+        /// \param count number of tasks in the batch
+        /// \note default implementation enqueues one task at a time
+        virtual void enqueue_tasks (task_proxy * tasks, std::size_t count) {
+            for (std::size_t i = 0; i < count; ++i) {
+                enqueue_task (std::move (tasks [i]));
+            }
+        }
+
+    private:
+
+        static void instrument (dispatcher_metrics & metrics, task_proxy & proxy);
+
+        std::mutex                                  _metrics_lock;
+        std::unique_ptr < dispatcher_metrics >      _metrics_owner;
+        std::atomic < dispatcher_metrics * >        _metrics { nullptr };
+    };
+
+    /// limits of a sync_dispatcher drain
+    struct dispatch_budget {
+        /// maximum number of tasks to execute
+        std::size_t                 max_tasks { std::numeric_limits < std::size_t >::max () };
+
+        /// maximum time spent executing tasks, checked between tasks
+        std::chrono::nanoseconds    max_time { std::chrono::nanoseconds::max () };
+    };
+
+    /// outcome of a time budgeted dispatch
+    struct dispatch_result {
+        /// number of executed tasks
+        std::size_t executed { 0 };
+
+        /// number of tasks left queued
+        std::size_t remaining { 0 };
     };
 
     /// synchronous task dispatcher
+    /// \note enqueueing is lock free, tasks are pushed to an intrusive list that the dispatching thread detaches
+    /// at once and executes in enqueue order
     class sync_dispatcher : public dispatcher {
     public:
+        sync_dispatcher () = default;
+        ~sync_dispatcher () override;
+
         /// check if the dispatcher is done
         /// \return true if the dispatcher has no more tasks to execute
         [[nodiscard]] bool is_done () const;
 
         /// dispatch all enqueued tasks
+        /// \note tasks enqueued while dispatching are executed on the next call. Can be called from a dispatched task
         void dispatch ();
+
+        /// dispatch enqueued tasks, including tasks enqueued while draining, until none is left or the budget is spent
+        /// \param budget task count and time limits
+        /// \return number of executed tasks
+        /// \note lets cascading tasks complete in a single call. Tasks left over stay queued in order
+        std::size_t drain (dispatch_budget const & budget = {});
+
+        /// dispatch enqueued tasks until the time budget is spent
+        /// \param budget maximum time spent executing tasks, checked between tasks
+        /// \return number of executed tasks and of tasks left queued, in order, for the next call
+        /// \note like dispatch, tasks enqueued while dispatching are left for the next call
+        dispatch_result dispatch_for (std::chrono::nanoseconds budget);
+
+        /// approximate number of enqueued tasks not yet executed
+        [[nodiscard]] std::size_t pending () const noexcept;
+
+        /// execute the oldest enqueued task on the calling thread
+        bool try_dispatch_one () override;
+
+        /// check if the calling thread is dispatching this dispatcher, only such threads may help it
+        [[nodiscard]] bool can_help_dispatch () const noexcept override;
     protected:
         void enqueue_task (task_proxy && proxy) override;
+        void enqueue_tasks (task_proxy * tasks, std::size_t count) override;
     private:
-        locked_value < std::vector < dispatcher::task_proxy > >
-            _queued_tasks,
-            _exec_tasks;
+
+        /// execute ready tasks within limits
+        /// \param should_refill move queued tasks to the ready list when it runs empty
+        /// \param budget task count and time limits
+        /// \return number of executed tasks
+        std::size_t run_ready_tasks (bool should_refill, dispatch_budget const & budget);
+
+        /// unhook the oldest ready task
+        /// \param should_refill move queued tasks to the ready list if it is empty
+        details::task_node * pop_ready_task (bool should_refill);
+
+        /// move queued tasks to the end of the ready list, ready lock held
+        void refill_ready_tasks ();
+
+        /// return executed task nodes for reuse by producers
+        void recycle (details::task_node * first, details::task_node * last);
+
+        // pushed by producers, most recent first
+        alignas (64) std::atomic < details::task_node * >
+                                        _queued_tasks { nullptr };
+        alignas (64) std::atomic < details::task_node * >
+                                        _free_nodes { nullptr };
+        alignas (64) std::atomic_size_t _pending { 0 };
+
+        // owned by dispatching threads, oldest first
+        alignas (64) mutable spin_mutex _ready_lock;
+        details::task_node *            _ready_head { nullptr };
+        details::task_node *            _ready_tail { nullptr };
+    };
+
+    /// asynchronous dispatcher task distribution strategy
+    enum struct async_dispatch_mode : uint8_t {
+        shared_queue,   ///< every task goes through a single shared queue
+        work_stealing   ///< each worker owns a deque, tasks enqueued by a worker stay local and idle workers steal
+    };
+
+    /// handling of a task posted to a bounded async_dispatcher while its queue is full
+    enum struct queue_overflow : uint8_t {
+        block,      ///< wait for room, a task posted from a worker runs inline instead
+        reject,     ///< throw std::system_error (resource_unavailable_try_again), nothing of a bulk post is enqueued
+        run_inline  ///< execute the task on the posting thread
+    };
+
+    /// asynchronous dispatcher configuration
+    struct async_dispatcher_options {
+        /// number of worker threads
+        std::size_t         thread_count { std::thread::hardware_concurrency () };
+
+        /// task distribution strategy
+        async_dispatch_mode mode { async_dispatch_mode::shared_queue };
+
+        /// pin each worker thread to a core, workers are packed on as few NUMA nodes as possible
+        /// \note if the cpu topology can not be read, workers are not pinned
+        bool                pin_threads { false };
+
+        /// when pinning, use a single hardware thread of each physical core
+        bool                skip_smt_siblings { true };
+
+        /// when pinning, group workers by NUMA node, idle workers steal from their own node first
+        bool                numa_aware { true };
+
+        /// record task metrics from the start, see dispatcher::enable_metrics
+        bool                enable_metrics { false };
+
+        /// maximum number of tasks in the shared queue, allocated up front. Zero for an unbounded queue
+        /// \note tasks kept local by a worker (work stealing deque, LIFO slot) are not bounded
+        std::size_t         queue_capacity { 0 };
+
+        /// bounded queue, handling of tasks posted while the queue is full
+        queue_overflow      overflow { queue_overflow::block };
+
+        /// the last normal task posted by a worker runs next on the same worker, see async_dispatcher::max_lifo_streak
+        /// \note a slot task is only taken by other workers while they search for work, a sleeping worker is woken for it
+        /// in case the posting task blocks on it
+        bool                use_lifo_slot { true };
+
+        /// resize the pool with the load, between min_thread_count and thread_count workers
+        bool                elastic { false };
+
+        /// elastic pool, number of workers kept when idle
+        std::size_t         min_thread_count { 1 };
+
+        /// elastic pool, start a worker once tasks are left waiting with every worker busy for this long
+        std::chrono::microseconds
+                            spawn_threshold { 1000 };
+
+        /// elastic pool, retire a worker after being idle for this long
+        std::chrono::milliseconds
+                            idle_timeout { 1000 };
     };
 
     /// asynchronous task dispatcher
+    /// \note tasks are executed by priority. To avoid starvation, lower priority lanes are periodically served
+    /// first, at least once every normal_aging_interval (normal) or background_aging_interval (background) picks.
+    /// An elastic pool checks its load when tasks are enqueued or completed, and retires workers from their idle wait
     class async_dispatcher : public dispatcher {
     public:
         /// dispatcher constructor
         /// \param thread_count number of threads to use
-        explicit async_dispatcher (std::size_t thread_count);
+        /// \param mode task distribution strategy
+        explicit async_dispatcher (std::size_t thread_count, async_dispatch_mode mode = async_dispatch_mode::shared_queue);
+
+        /// dispatcher constructor
+        /// \param options dispatcher configuration
+        explicit async_dispatcher (async_dispatcher_options const & options);
         ~async_dispatcher() override;
 
         /// stop execution and join all threads
         /// \note automatically called by the destructor
         void join ();
+
+        /// task distribution strategy in use
+        [[nodiscard]] async_dispatch_mode mode () const noexcept { return _mode; }
+
+        /// shared queue capacity, zero if unbounded
+        [[nodiscard]] std::size_t queue_capacity () const noexcept { return _queue_capacity; }
+
+        /// Post a task if the queue has room, never blocks or runs the task inline
+        /// \tparam func_t callable type
+        /// \tparam args_t arguments type vector
+        /// \param func callable object
+        /// \param args arguments, stored by value and passed to the callable as lvalues
+        /// \return true if the task was enqueued, false if the bounded queue is full
+        template < typename func_t, typename ... args_t >
+        [[nodiscard]] bool try_post (func_t && func, args_t && ... args)
+        {
+            return try_enqueue_task (make_task (std::forward < func_t > (func), std::forward < args_t > (args)...), task_priority::normal);
+        }
+
+        /// Post a task with a given priority if the queue has room, never blocks or runs the task inline
+        /// \tparam func_t callable type
+        /// \tparam args_t arguments type vector
+        /// \param priority task scheduling priority
+        /// \param func callable object
+        /// \param args arguments, stored by value and passed to the callable as lvalues
+        /// \return true if the task was enqueued, false if the bounded queue is full
+        template < typename func_t, typename ... args_t >
+        [[nodiscard]] bool try_post (task_priority priority, func_t && func, args_t && ... args)
+        {
+            return try_enqueue_task (make_task (std::forward < func_t > (func), std::forward < args_t > (args)...), priority);
+        }
+
+        /// maximum number of worker threads
+        [[nodiscard]] std::size_t concurrency () const noexcept override;
+
+        /// number of running worker threads
+        /// \note only changes over time for an elastic pool
+        [[nodiscard]] std::size_t worker_count () const noexcept {
+            return _active_workers.load (std::memory_order_relaxed);
+        }
+
+        bool try_dispatch_one () override;
+
+        /// picks between two picks that serve the normal lane first
+        static constexpr std::size_t normal_aging_interval { 8 };
+
+        /// picks between two picks that serve the background lane first
+        static constexpr std::size_t background_aging_interval { 64 };
+
+        /// consecutive tasks a worker takes from its LIFO slot before the slot task is sent to the shared queue
+        static constexpr std::size_t max_lifo_streak { 3 };
     protected:
         void enqueue_task (task_proxy && proxy) override;
+        void enqueue_tasks (task_proxy * tasks, std::size_t count) override;
+        void enqueue_priority_task (task_proxy && proxy, task_priority priority) override;
+        void collect_metrics (dispatcher_metrics_snapshot & snapshot) const override;
     private:
 
+        using task_lanes = std::array < ring_buffer < dispatcher::task_proxy >, task_priority_count >;
+
+        struct worker;
+
+        [[nodiscard]] worker * this_worker () const noexcept;
+
+        void worker_loop (worker & self);
+
+        bool spin_for_task (worker & self, task_proxy & task);
+
+        bool try_acquire_task (worker * self, task_proxy & task);
+
+        bool try_steal_task (worker * self, task_proxy & task);
+
+        bool try_take_lifo_task (worker & self, task_proxy & task);
+
+        bool try_steal_lifo_task (worker * self, task_proxy & task);
+
+        bool try_acquire_lane_task (bool should_block, task_proxy & task);
+
+        bool pop_lane_task (task_lanes & lanes, task_proxy & task);
+
+        bool try_enqueue_task (task_proxy && proxy, task_priority priority);
+
+        [[nodiscard]] bool has_room (std::size_t count) const noexcept;
+
+        bool try_push_lane_task (task_lanes & lanes, task_proxy & task, task_priority priority);
+
+        /// move a task into a worker's LIFO slot, the task it displaces into the bounded shared queue
+        /// \return false, leaving the slot untouched, if the displaced task would not fit
+        bool try_push_lifo_task (task_lanes & lanes, worker & self, task_proxy & task);
+
+        void push_lane_task (task_proxy && task, task_priority priority);
+
+        [[nodiscard]] bool has_pending_tasks ();
+
+        void start_worker (worker & self);
+
+        void check_saturation ();
+
+        bool try_retire (worker & self);
+
+        static thread_local worker *    _this_worker;
+
+        async_dispatch_mode const       _mode;
+        bool const                      _use_lifo_slot;
+
+        bool const                      _is_elastic;
+        std::size_t const               _min_workers;
+        std::chrono::nanoseconds const  _spawn_threshold;
+        std::chrono::milliseconds const _idle_timeout;
+
+        std::mutex                      _resize_lock;
+        std::atomic_size_t              _active_workers { 0 };
+        std::atomic_int64_t             _saturated_since { 0 };
+
+        std::vector < std::unique_ptr < worker > >
+                                        _workers;
         std::vector < std::thread >     _worker_threads;
 
-        locked_value <std::queue < dispatcher::task_proxy >, std::mutex>
+        locked_value < task_lanes, std::mutex >
                                         _tasks;
-        std::condition_variable         _exec_condition;
+        std::size_t                     _lane_tick { 0 };
+        std::atomic_size_t              _lane_size { 0 };
+        std::size_t const               _queue_capacity;
+        queue_overflow const            _overflow;
+        event_count                     _lane_space;
+        std::atomic_size_t              _high_tasks { 0 };
+        event_count                     _parking;
         std::atomic_bool 		        _is_running { true };
 
     };
 
+    /// Serial executor, runs its tasks one at a time and in enqueue order on a target dispatcher
+    /// \note tasks are queued without locks and a single drain task is posted to the target while tasks are pending,
+    /// no worker thread is blocked waiting on a strand. A strand holds no thread or allocation of its own, creating
+    /// many is cheap. The strand must outlive its queued tasks
+    class strand : public dispatcher {
+    public:
+        /// strand constructor
+        /// \param target dispatcher executing the strand's tasks
+        explicit strand (dispatcher & target) noexcept;
+        ~strand () override;
+
+        /// dispatcher executing the strand's tasks
+        [[nodiscard]] dispatcher & target () const noexcept { return _target; }
+
+        /// check if the calling thread is executing a task of this strand
+        [[nodiscard]] bool running_in_this_thread () const noexcept;
+
+        [[nodiscard]] std::size_t concurrency () const noexcept override {
+            return 1;
+        }
+
+        /// tasks executed per drain before the target thread is handed back to other work
+        static constexpr std::size_t batch_size { 64 };
+    protected:
+        void enqueue_task (task_proxy && proxy) override;
+        void enqueue_tasks (task_proxy * tasks, std::size_t count) override;
+    private:
+
+        /// hook queued tasks and post a drain if none is scheduled
+        void push_nodes (details::task_node * first, details::task_node * last);
+
+        /// execute up to batch_size tasks, on the target dispatcher
+        void drain ();
+
+        /// move queued tasks to the end of the ready list
+        void refill_ready_tasks ();
+
+        static thread_local strand *    _this_strand;
+
+        dispatcher &                    _target;
+
+        // pushed by producers, most recent first
+        std::atomic < details::task_node * >
+                                        _queued_tasks { nullptr };
+        std::atomic_bool                _is_scheduled { false };
+
+        // owned by the running drain, oldest first
+        details::task_node *            _ready_head { nullptr };
+        details::task_node *            _ready_tail { nullptr };
+    };
+
 }
 
 #endif
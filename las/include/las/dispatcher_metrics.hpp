@@ -0,0 +1,117 @@
+#pragma once
+#ifndef LAS_DISPATCHER_METRICS_HPP
+#define LAS_DISPATCHER_METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "las/details.hpp"
+#include "las/histogram.hpp"
+
+namespace las {
+
+    /// Point in time copy of a dispatcher's metrics
+    struct dispatcher_metrics_snapshot {
+
+        /// activity of a thread that executed tasks
+        struct worker_activity {
+            /// time spent executing tasks
+            std::chrono::nanoseconds busy { 0 };
+
+            /// time since the first executed task not spent executing tasks
+            std::chrono::nanoseconds idle { 0 };
+
+            /// fraction of time spent executing tasks
+            [[nodiscard]] double busy_ratio () const noexcept {
+                auto const TOTAL = busy + idle;
+                return TOTAL.count () > 0 ? static_cast < double > (busy.count ()) / static_cast < double > (TOTAL.count ()) : 0.0;
+            }
+        };
+
+        /// number of enqueued tasks
+        uint64_t                        enqueued { 0 };
+
+        /// number of executed tasks
+        uint64_t                        executed { 0 };
+
+        /// number of tasks enqueued and not yet started
+        std::size_t                     queue_depth { 0 };
+
+        /// largest queue depth observed
+        std::size_t                     peak_queue_depth { 0 };
+
+        /// time between enqueue and start of execution, in nanoseconds
+        histogram                       wait_time;
+
+        /// task execution time, in nanoseconds
+        histogram                       execution_time;
+
+        /// one entry per thread that executed tasks
+        std::vector < worker_activity > workers;
+
+        /// number of running worker threads, zero for dispatchers without workers
+        std::size_t                     worker_count { 0 };
+
+        /// worker threads started by an elastic pool
+        uint64_t                        spawned_workers { 0 };
+
+        /// worker threads retired by an elastic pool
+        uint64_t                        retired_workers { 0 };
+    };
+
+    /// Dispatcher instrumentation, records task counts, queue depth and timings
+    /// \note counters are kept per thread, only the queue depth is shared between threads
+    class dispatcher_metrics : no_copy {
+    public:
+
+        using clock_type = std::chrono::steady_clock;
+
+        dispatcher_metrics ();
+        ~dispatcher_metrics ();
+
+        /// record enqueued tasks
+        /// \param count number of enqueued tasks
+        void on_enqueue (std::size_t count);
+
+        /// record a task leaving the queue
+        void on_dequeue () noexcept;
+
+        /// record an executed task
+        /// \param wait time spent in the queue
+        /// \param execution time spent executing
+        void on_execute (std::chrono::nanoseconds wait, std::chrono::nanoseconds execution);
+
+        /// record a worker pool resize
+        /// \param is_growing true if a worker was started, false if a worker was retired
+        void on_resize (bool is_growing) noexcept;
+
+        /// collect the counters of every thread
+        [[nodiscard]] dispatcher_metrics_snapshot snapshot () const;
+
+    private:
+
+        struct thread_counters;
+
+        /// counters of the calling thread, registered on first use
+        thread_counters & this_thread_counters ();
+
+        uint64_t const                  ID;
+
+        alignas (64) std::atomic_size_t _queue_depth { 0 };
+        alignas (64) std::atomic_size_t _peak_queue_depth { 0 };
+        std::atomic_uint64_t            _spawned_workers { 0 };
+        std::atomic_uint64_t            _retired_workers { 0 };
+
+        mutable std::mutex              _registry_lock;
+        std::vector < std::unique_ptr < thread_counters > >
+                                        _registry;
+    };
+
+}
+
+#endif
@@ -140,6 +140,8 @@ namespace las {
 
         // WARNING: handle reference types with care, deferred execution of references
         // may lead to access to no longer used memory addresses.
+        // NOTE: exceptions thrown by observers are captured by the task's discarded future, as
+        // they are not to escape into the executing thread
         void invoke(dispatcher &dispatcher, args_t ... args) {
             std::unique_lock const LOCK (_internal_mutex);
 
@@ -178,7 +180,7 @@ namespace las {
             auto erase_it = std::remove_if(
                     _observers.begin(), _observers.end(),
                     [id](std::shared_ptr<observer_base> &item) {
-                        return item->id == id;
+                        return item->ID == id;
                     });
 
             if (erase_it == _observers.end()) {
@@ -0,0 +1,126 @@
+#pragma once
+#ifndef LAS_EVENT_COUNT_HPP
+#define LAS_EVENT_COUNT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <las/details.hpp>
+#include <las/system.hpp>
+
+namespace las {
+
+    /// Event count, lets threads sleep on a condition without a mutex
+    /// \note waiters call prepare_wait, check their condition and then either cancel_wait or commit_wait.
+    /// Notifiers change the condition and then call notify, which only issues a wake system call if a
+    /// thread is actually waiting
+    struct event_count : no_copy {
+        static_assert (std::is_standard_layout_v <std::atomic_int32_t>, "std::atomic_int must be standard layout");
+
+        /// wait key, identifies the epoch observed by prepare_wait
+        using key_type = futex_value_t;
+
+        /// register the calling thread as a waiter
+        /// \return key to be used with commit_wait
+        /// \note the waiting condition must be checked after this call
+        [[nodiscard]] key_type prepare_wait () noexcept {
+            _waiters.fetch_add (1, std::memory_order_seq_cst);
+
+            // pairs with the fence in notify, either the notifier sees the waiter
+            // or the waiter sees the changed condition
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+
+            return _epoch.atomic.load (std::memory_order_seq_cst);
+        }
+
+        /// unregister the calling thread, the waiting condition was met
+        void cancel_wait () noexcept {
+            _waiters.fetch_sub (1, std::memory_order_relaxed);
+        }
+
+        /// sleep until a notification newer than key is issued
+        /// \param key value returned by prepare_wait
+        void commit_wait (key_type key) noexcept {
+            while (_epoch.atomic.load (std::memory_order_acquire) == key) {
+                futex_wait (&_epoch.integer, key);
+            }
+
+            _waiters.fetch_sub (1, std::memory_order_relaxed);
+        }
+
+        /// sleep until a notification newer than key is issued or a timeout expires
+        /// \param key value returned by prepare_wait
+        /// \param timeout maximum time to sleep
+        /// \return true if notified, false if the timeout expired
+        bool commit_wait_for (key_type key, std::chrono::milliseconds timeout) noexcept {
+            auto const DEADLINE = std::chrono::steady_clock::now () + timeout;
+            bool is_notified { true };
+
+            while (_epoch.atomic.load (std::memory_order_acquire) == key) {
+                auto const REMAINING = std::chrono::ceil < std::chrono::milliseconds > (DEADLINE - std::chrono::steady_clock::now ());
+
+                // a zero timeout would wait forever
+                if (REMAINING <= std::chrono::milliseconds::zero ()) {
+                    is_notified = false;
+                    break;
+                }
+
+                futex_wait (&_epoch.integer, key, REMAINING);
+            }
+
+            _waiters.fetch_sub (1, std::memory_order_relaxed);
+            return is_notified;
+        }
+
+        /// wake up to count waiting threads
+        /// \param count maximum number of threads to wake up
+        void notify (std::size_t count = 1) noexcept {
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+
+            auto const WAITERS = static_cast < std::size_t > (_waiters.load (std::memory_order_relaxed));
+
+            if (WAITERS == 0 || count == 0) {
+                return;
+            }
+
+            _epoch.atomic.fetch_add (1, std::memory_order_seq_cst);
+
+            if (count >= WAITERS) {
+                futex_wake_all (&_epoch.integer);
+                return;
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                futex_wake_one (&_epoch.integer);
+            }
+        }
+
+        /// wake up every waiting thread
+        void notify_all () noexcept {
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+
+            if (_waiters.load (std::memory_order_relaxed) == 0) {
+                return;
+            }
+
+            _epoch.atomic.fetch_add (1, std::memory_order_seq_cst);
+            futex_wake_all (&_epoch.integer);
+        }
+
+        /// number of threads between prepare_wait and the end of the wait
+        [[nodiscard]] std::size_t waiters () const noexcept {
+            return static_cast < std::size_t > (_waiters.load (std::memory_order_relaxed));
+        }
+
+    private:
+        union {
+            std::atomic_int32_t atomic;
+            int32_t             integer;
+        } _epoch {0};
+
+        std::atomic_int32_t _waiters {0};
+    };
+}
+
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef LAS_HISTOGRAM_HPP
+#define LAS_HISTOGRAM_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace las {
+
+    /// Log-linear histogram of unsigned values, usually nanosecond durations
+    /// \note values below sub_bucket_count are exact, larger values are grouped by power of two and split in
+    /// sub_bucket_count linear buckets, the relative error of a reported value is below 1 / sub_bucket_count
+    class histogram {
+    public:
+
+        using value_type = uint64_t;
+
+        /// linear sub buckets per power of two
+        static constexpr std::size_t sub_bucket_bits { 3 };
+        static constexpr std::size_t sub_bucket_count { std::size_t { 1 } << sub_bucket_bits };
+
+        /// total number of buckets, covers the whole value_type range
+        static constexpr std::size_t bucket_count { (64 - sub_bucket_bits + 1) * sub_bucket_count };
+
+        /// record a value
+        /// \param value value to record
+        /// \param count number of times the value is recorded
+        void record (value_type value, uint64_t count = 1) noexcept;
+
+        /// record a duration in nanoseconds, negative durations are recorded as zero
+        /// \param span duration to record
+        void record (std::chrono::nanoseconds span) noexcept {
+            record (static_cast < value_type > (span.count () < 0 ? 0 : span.count ()));
+        }
+
+        /// add every value recorded by another histogram
+        void merge (histogram const & other) noexcept;
+
+        /// clear every recorded value
+        void reset () noexcept;
+
+        /// number of recorded values
+        [[nodiscard]] uint64_t count () const noexcept { return _count; }
+
+        /// sum of the recorded values
+        [[nodiscard]] value_type sum () const noexcept { return _sum; }
+
+        /// smallest recorded value, zero if empty
+        [[nodiscard]] value_type min () const noexcept { return _count ? _min : 0; }
+
+        /// largest recorded value, zero if empty
+        [[nodiscard]] value_type max () const noexcept { return _max; }
+
+        /// average of the recorded values, zero if empty
+        [[nodiscard]] double mean () const noexcept;
+
+        /// estimate the value below which a fraction of the recorded values fall
+        /// \param fraction percentile as a fraction in [0, 1] (ex: 0.99 for p99)
+        /// \return the estimated value, within the recorded min and max, zero if empty
+        [[nodiscard]] value_type percentile (double fraction) const noexcept;
+
+        /// number of values recorded in a bucket
+        [[nodiscard]] uint64_t bucket (std::size_t index) const noexcept { return _buckets [index]; }
+
+        /// bucket holding a value
+        [[nodiscard]] static std::size_t bucket_index (value_type value) noexcept;
+
+        /// smallest value held by a bucket
+        [[nodiscard]] static value_type bucket_lower_bound (std::size_t index) noexcept;
+
+        /// largest value held by a bucket
+        [[nodiscard]] static value_type bucket_upper_bound (std::size_t index) noexcept;
+
+    private:
+        std::array < uint64_t, bucket_count >   _buckets {};
+        uint64_t                                _count { 0 };
+        value_type                              _sum { 0 };
+        value_type                              _min { std::numeric_limits < value_type >::max () };
+        value_type                              _max { 0 };
+    };
+
+}
+
+#endif
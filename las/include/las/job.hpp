@@ -5,10 +5,21 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <string>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 
+#include "config.hpp"
+
+#if defined (LAS_OS_GNU_LINUX)
+#	include <pthread.h>
+#endif
+
 #include "details.hpp"
+#include "histogram.hpp"
+#include "spin_mutex.hpp"
+#include "system.hpp"
 #include "traits.hpp"
 
 namespace las {
@@ -23,89 +34,296 @@ namespace las {
 		using return_type = return_t;
 	};
 
-	struct job_token {
-	public:
+	class job_stop_callback;
 
-		struct context_t {
-		public:
+	/// Runtime statistics of a job's interval loop, updated by interval_wait
+	struct job_statistics {
+		/// number of completed iterations, each ending with an interval wait
+		uint64_t					iterations { 0 };
 
-			std::atomic_bool 			stop_request {};
-			std::chrono::milliseconds 	interval {};
+		/// iterations that did not complete within their interval
+		uint64_t					overruns { 0 };
 
-			std::chrono::high_resolution_clock::time_point
-				time_point {};
-		};
+		/// time spent executing each iteration, in nanoseconds
+		histogram					execution_time;
 
-		inline void interval_reset (std::chrono::milliseconds interval) {
-			context->time_point = std::chrono::high_resolution_clock::now();
-			context->interval = interval;
-		}
+		/// total time spent waiting for intervals
+		std::chrono::nanoseconds	sleep_time { 0 };
+	};
+
+	/// Stop flag and interval state of a job, owned by the job and shared by reference with its thread
+	/// \note the stop flag is kept apart from the callback list so polling it never shares a line with registrations
+	struct alignas (64) job_state : no_copy {
+	public:
+
+		using clock_type = std::chrono::steady_clock;
 
-		inline void interval_reset () {
-			interval_reset (context->interval);
+		/// request the job to stop, wake it from interval waits and invoke its stop callbacks, on the calling thread
+		/// \return true if this call requested the stop, false if it was already requested
+		bool request_stop ();
+
+		[[nodiscard]]
+		inline bool stop_requested () const noexcept {
+			return _stop_request.atomic.load (std::memory_order_acquire) != 0;
 		}
 
-		inline void interval_wait () {
-			using namespace std::chrono;
+		/// block until a point in time or until a stop is requested
+		/// \param time_point point in time to wake up at
+		/// \return true if the point in time was reached, false if a stop was requested
+		bool wait_until (clock_type::time_point time_point) noexcept;
 
-			if (context->interval.count () == 0) {
-				std::this_thread::yield();
-				return;
-			}
+		/// end the current iteration and move the deadline to the end of the next interval
+		/// \param now current point in time
+		/// \return end of the current interval, now if it was overrun or if the interval is zero
+		/// \note intervals missed by an overrun are skipped, keeping the original phase
+		clock_type::time_point begin_wait (clock_type::time_point now) noexcept;
 
-			auto exec_span = high_resolution_clock::now () - context->time_point;
-			auto rem_time = context->interval - exec_span;
+		/// start the next iteration once the wait is over
+		/// \param now current point in time
+		void end_wait (clock_type::time_point now) noexcept;
 
-			if (rem_time.count () > 0) {
-                std::this_thread::sleep_for(rem_time);
-            } else {
-                std::this_thread::yield();
-            }
+		/// copy of the loop statistics
+		[[nodiscard]]
+		job_statistics statistics () const;
 
-			context->time_point = high_resolution_clock::now();
-		}
+		std::chrono::milliseconds 	interval {};
+
+		/// end of the current interval
+		clock_type::time_point 		deadline {};
+
+		/// start of the current iteration
+		clock_type::time_point 		iteration_start { clock_type::now () };
+
+	private:
+		friend class job_stop_callback;
+
+		union {
+			std::atomic_int32_t atomic;
+			int32_t             integer;
+		} _stop_request { 0 };
+
+		alignas (64) spin_mutex		_callback_lock;
+		job_stop_callback *			_callbacks { nullptr };
+		job_stop_callback *			_running_callback { nullptr };
+		std::thread::id				_stopping_thread {};
+
+		// only contended while statistics are read
+		alignas (64) mutable spin_mutex	_statistics_lock;
+		job_statistics					_statistics;
+		clock_type::time_point			_wait_start {};
+	};
+
+	/// Handle to a job's state, cheap to copy
+	/// \note a token refers to its job's state without owning it and must not outlive the job. A default constructed
+	/// token owns a standalone state instead, shared by its copies, which can be stopped as a job's
+	struct job_token {
+	public:
+
+		/// standalone token, not bound to a job
+		job_token ();
+
+		/// token of a job
+		/// \param state state of the job, must outlive the token
+		explicit job_token (job_state * state) noexcept :
+			_state { state }
+		{}
+
+		/// start a new interval of a given length from now
+		void interval_reset (std::chrono::milliseconds interval);
+
+		/// start a new interval from now
+		void interval_reset ();
+
+		/// block until the end of the current interval, and start the next one, or until a stop is requested
+		/// \note intervals follow each other from absolute deadlines, the time spent waking up never accumulates.
+		/// Intervals missed by an overrun are skipped, keeping the original phase
+		void interval_wait ();
 
 		[[nodiscard]]
-        inline bool stop_requested () const {
-			return context->stop_request.load ();
+		inline bool stop_requested () const noexcept {
+			return _state->stop_requested ();
 		}
 
-		inline void stop () {
-			context->stop_request.store (true);
+		void stop ();
+
+	private:
+		friend class job_stop_callback;
+
+		/// state of a standalone token, empty for a job's token
+		std::shared_ptr < job_state >	_standalone;
+		job_state *						_state { nullptr };
+	};
+
+	/// Callback invoked once when a job is stopped, while registered
+	/// \note invoked immediately if the job was already stopped. Unregistering waits for a running invocation to
+	/// complete, unless called from within the callback itself. Use to wake a job blocked outside interval_wait.
+	/// The callback keeps a standalone token's state alive, a job's token must outlive it
+	class job_stop_callback : no_copy, no_move {
+	public:
+
+		template < typename func_t >
+		job_stop_callback (job_token const & token, func_t && func) :
+			_callback { std::forward < func_t > (func) },
+			_standalone { token._standalone },
+			_state { token._state }
+		{
+			attach ();
 		}
 
-		std::shared_ptr < context_t >
-			context {std::make_shared < context_t > () };
+		~job_stop_callback ();
+
+	private:
+		friend struct job_state;
+
+		void attach ();
+
+		std::function < void () >	_callback;
+		std::shared_ptr < job_state >	_standalone;
+		job_state *					_state;
+		job_stop_callback *			_prev { nullptr };
+		job_stop_callback *			_next { nullptr };
+		bool						_is_registered { false };
+	};
+
+	/// scheduling policy of a job thread
+	enum struct job_sched_policy : uint8_t {
+		inherit,		///< policy and priority of the creating thread
+		other,			///< default time sharing (SCHED_OTHER)
+		fifo,			///< real time, first in first out (SCHED_FIFO)
+		round_robin,	///< real time, round robin (SCHED_RR)
+		batch,			///< non interactive time sharing (SCHED_BATCH)
+		idle			///< lowest priority (SCHED_IDLE)
 	};
 
+	/// job thread launch options, applied before the job body runs
+	/// \note scheduling and stack size are only supported on linux, where real time policies may require privileges
+	struct job_options {
+		/// core the thread is pinned to, UNDEFINED_CORE_ID to leave the affinity unchanged
+		core_id_t			core { UNDEFINED_CORE_ID };
+
+		/// scheduling policy
+		job_sched_policy	policy { job_sched_policy::inherit };
+
+		/// scheduling priority, within the policy's range (1 to 99 for real time policies)
+		int					priority { 0 };
+
+		/// thread stack size in bytes, zero for the system default
+		std::size_t			stack_size { 0 };
+
+		/// thread name, truncated to 15 characters on linux. Empty to leave it unchanged
+		std::string			name;
+	};
+
+	namespace details {
+
+		/// type erased job thread body
+		class job_body {
+		public:
+			virtual ~job_body () = default;
+			virtual void run () = 0;
+		};
+
+		template < typename func_t, typename ... args_t >
+		class job_body_impl final : public job_body {
+		public:
+
+			template < typename call_t, typename ... call_args_t >
+			explicit job_body_impl (call_t && call, call_args_t && ... args_v) :
+				_call { std::forward < call_t > (call), std::forward < call_args_t > (args_v)... }
+			{}
+
+			void run () override {
+				std::apply ([](auto && ... items) { std::invoke (std::move (items)...); }, _call);
+			}
+
+		private:
+			std::tuple < func_t, args_t... > _call;
+		};
+
+		template < typename call_t, typename ... args_t >
+		std::unique_ptr < job_body > make_job_body (call_t && call, args_t && ... args_v) {
+			return std::make_unique < job_body_impl < std::decay_t < call_t >, std::decay_t < args_t >... > > (
+				std::forward < call_t > (call),
+				std::forward < args_t > (args_v)...);
+		}
+
+		/// thread of a job, started with launch options
+		/// \note std::thread can not set a stack size or a scheduling policy at creation, pthreads are used on linux
+		class job_thread : no_copy {
+		public:
+
+			job_thread () noexcept = default;
+
+			/// start a thread
+			/// \param options launch options
+			/// \param body body to run, after the options are applied
+			/// \throws std::system_error if the thread can not be created with the requested options
+			job_thread (job_options const & options, std::unique_ptr < job_body > body);
+
+			job_thread (job_thread && other) noexcept;
+
+			job_thread & operator = (job_thread && other) noexcept;
+
+			/// terminates if the thread was not joined, as std::thread
+			~job_thread ();
+
+			[[nodiscard]]
+			bool joinable () const noexcept;
+
+			void join ();
+
+			void swap (job_thread & other) noexcept;
+
+		private:
+#if defined (LAS_OS_GNU_LINUX)
+			pthread_t	_handle {};
+			bool		_is_joinable { false };
+#else
+			std::thread	_thread;
+#endif
+		};
+
+	}
+
 	class job : no_copy {
 	public:
 
 		job ();
 
-		template < typename call_t, typename ... args_t >
+		template < typename call_t, typename ... args_t, std::enable_if_t < !std::is_same_v < std::decay_t < call_t >, job_options >, int > = 0 >
 		inline explicit job (
                 call_t && call, args_t && ... args_v
 		) :
-			_token {},
+			job (job_options {}, std::forward<call_t>(call), std::forward<args_t>(args_v)...)
+		{}
+
+		/// start a job thread with launch options
+		/// \throws std::system_error if the thread can not be created with the requested options
+		template < typename call_t, typename ... args_t >
+		inline job (
+				job_options const & options, call_t && call, args_t && ... args_v
+		) :
+			_state { std::make_unique < job_state > () },
 			_thread {
-				[](auto call, auto token, auto ... args_v) {
-					this_token = token;
-
-					if constexpr (std::is_invocable_v<std::decay_t<decltype(call)>, decltype (token), decltype(args_v)...>) {
-						std::invoke(
-							std::forward<decltype(call)>(call),
-							token,
-							std::forward<decltype(args_v)>(args_v)...);
-					} else {
-                        std::invoke(
-                                std::forward<decltype(call)>(call),
-                                std::forward<decltype(args_v)>(args_v)...);
-					}
-				},
-				std::forward<call_t>(call),
-				_token,
-				std::forward<args_t>(args_v)...
+				options,
+				details::make_job_body (
+					[](auto call, job_token token, auto ... args_v) {
+						this_token = token;
+
+						if constexpr (std::is_invocable_v<std::decay_t<decltype(call)>, job_token, decltype(args_v)...>) {
+							std::invoke(
+								std::forward<decltype(call)>(call),
+								token,
+								std::forward<decltype(args_v)>(args_v)...);
+						} else {
+							std::invoke(
+									std::forward<decltype(call)>(call),
+									std::forward<decltype(args_v)>(args_v)...);
+						}
+					},
+					std::forward<call_t>(call),
+					job_token { _state.get () },
+					std::forward<args_t>(args_v)...)
 			}
 		{}
 
@@ -118,6 +336,15 @@ namespace las {
 
 		void stop ();
 
+		/// token of the running job, a standalone token for a default constructed job
+		/// \note the token must not outlive the job
+		[[nodiscard]]
+		job_token token () const;
+
+		/// copy of the job's interval loop statistics, empty for a default constructed job
+		[[nodiscard]]
+		job_statistics statistics () const;
+
 		[[nodiscard]]
 		bool joinable () const noexcept;
 
@@ -129,9 +356,10 @@ namespace las {
 
 	private:
 		// the order of these fields is important, keep it as
-		// thread depends on _token being instanced
-		job_token 	_token;
-		std::thread _thread;
+		// thread depends on _state being instanced. The state is
+		// allocated so its address survives moving the job
+		std::unique_ptr < job_state >	_state;
+		details::job_thread				_thread;
 	};
 }
 
@@ -0,0 +1,387 @@
+#pragma once
+#ifndef LAS_JOB_HOST_HPP
+#define LAS_JOB_HOST_HPP
+
+#include "las/config.hpp"
+
+#if defined (LAS_HAS_COROUTINES)
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "las/debug.hpp"
+#include "las/details.hpp"
+#include "las/dispatcher.hpp"
+#include "las/job.hpp"
+#include "las/spin_mutex.hpp"
+#include "las/system.hpp"
+#include "las/task.hpp"
+#include "las/timer_wheel.hpp"
+
+namespace las {
+
+    class job_host;
+
+    namespace details {
+
+        /// state of a job running on a job_host, shared by its handle, its coroutine and its pending timer
+        class hosted_job_state : public std::enable_shared_from_this < hosted_job_state >, no_copy {
+        public:
+
+            explicit hosted_job_state (job_host & host) :
+                _host { &host },
+                _wake_on_stop { job_token { &state }, [this]() { wake (0); } }
+            {}
+
+            /// resume the job at a point in time, or as soon as possible if a stop is requested
+            /// \param time_point point in time to resume at, resumes immediately if already reached
+            /// \param handle suspended job coroutine
+            inline void sleep_until (job_state::clock_type::time_point time_point, std::coroutine_handle <> handle);
+
+            /// resume a sleeping job
+            /// \param generation sleep to end, zero for any
+            inline void wake (uint64_t generation);
+
+            /// resume a job coroutine on a host thread
+            inline void resume (std::coroutine_handle <> handle);
+
+            /// mark the job as finished and wake its joiners
+            inline void finish () noexcept {
+                _is_done.atomic.store (1, std::memory_order_release);
+                futex_wake_all (&_is_done.integer);
+            }
+
+            [[nodiscard]] bool is_done () const noexcept {
+                return _is_done.atomic.load (std::memory_order_acquire) != 0;
+            }
+
+            /// block until the job finishes
+            void join () noexcept {
+                while (!is_done ()) {
+                    futex_wait (&_is_done.integer, 0);
+                }
+            }
+
+            job_state                   state;
+
+        private:
+            job_host *                  _host;
+            job_stop_callback           _wake_on_stop;
+
+            spin_mutex                  _lock;
+            std::coroutine_handle <>    _sleeping {};
+            timer_id                    _timer {};
+            uint64_t                    _generation { 0 };
+
+            union {
+                std::atomic_int32_t atomic;
+                int32_t             integer;
+            } _is_done { 0 };
+        };
+
+    }
+
+    /// Token of a job running on a job_host
+    /// \note same interface as job_token, except interval_wait which must be awaited, as in
+    /// `co_await token.interval_wait ()`, releasing the host thread while the job sleeps
+    struct hosted_job_token : job_token {
+    public:
+
+        /// suspends the job until the end of its interval
+        class interval_awaitable {
+        public:
+            explicit interval_awaitable (details::hosted_job_state & job) noexcept :
+                _job { job }
+            {}
+
+            [[nodiscard]] bool await_ready () noexcept {
+                auto & state = _job.state;
+
+                if (state.stop_requested ()) {
+                    return true;
+                }
+
+                // a zero interval or an overrun yields the host thread to other jobs
+                _wake = state.begin_wait (job_state::clock_type::now ());
+                _is_waiting = true;
+
+                return false;
+            }
+
+            void await_suspend (std::coroutine_handle <> handle) {
+                _job.sleep_until (_wake, handle);
+            }
+
+            void await_resume () noexcept {
+                if (_is_waiting) {
+                    _job.state.end_wait (job_state::clock_type::now ());
+                }
+            }
+
+        private:
+            details::hosted_job_state &         _job;
+            job_state::clock_type::time_point   _wake {};
+            bool                                _is_waiting { false };
+        };
+
+        explicit hosted_job_token (details::hosted_job_state & job) noexcept :
+            job_token { &job.state },
+            _job { &job }
+        {}
+
+        /// suspend the job until the end of the current interval, and start the next one, or until a stop is requested
+        /// \return awaitable, used as `co_await token.interval_wait ()`
+        /// \note follows the same absolute deadlines as job_token::interval_wait
+        [[nodiscard]] interval_awaitable interval_wait () const noexcept {
+            return interval_awaitable { *_job };
+        }
+
+    private:
+        details::hosted_job_state * _job;
+    };
+
+    /// Handle to a job running on a job_host, stops and joins the job when destroyed
+    class hosted_job : no_copy {
+    public:
+
+        hosted_job () = default;
+
+        explicit hosted_job (std::shared_ptr < details::hosted_job_state > job) noexcept :
+            _job { std::move (job) }
+        {}
+
+        hosted_job (hosted_job && other) noexcept :
+            _job { std::move (other._job) }
+        {}
+
+        hosted_job & operator = (hosted_job && other) noexcept {
+            this->swap (other);
+            return *this;
+        }
+
+        ~hosted_job () {
+            if (joinable ()) {
+                stop ();
+                join ();
+            }
+        }
+
+        /// request the job to stop, waking it if sleeping
+        void stop () {
+            if (_job) {
+                _job->state.request_stop ();
+            }
+        }
+
+        /// token of the job, a standalone token for a default constructed handle
+        /// \note the token must not outlive the handle
+        [[nodiscard]] job_token token () const {
+            return _job ? job_token { &_job->state } : job_token {};
+        }
+
+        /// copy of the job's interval loop statistics, empty for a default constructed handle
+        [[nodiscard]] job_statistics statistics () const {
+            return _job ? _job->state.statistics () : job_statistics {};
+        }
+
+        /// check if the handle refers to a job that was not joined
+        [[nodiscard]] bool joinable () const noexcept {
+            return static_cast < bool > (_job);
+        }
+
+        /// check if the job has returned
+        [[nodiscard]] bool is_done () const noexcept {
+            return !_job || _job->is_done ();
+        }
+
+        /// block until the job returns
+        /// \note joining from a job of the same host occupies one of its threads while waiting
+        void join () {
+            if (!_job) {
+                LAS_DEBUG_BREAK(); // Joining an empty hosted job. Call ignored!
+                return;
+            }
+
+            _job->join ();
+            _job.reset ();
+        }
+
+        void swap (hosted_job & other) noexcept {
+            std::swap (_job, other._job);
+        }
+
+    private:
+        std::shared_ptr < details::hosted_job_state > _job;
+    };
+
+    /// Runs many long lived jobs as coroutines on a small, fixed pool of threads
+    /// \note a hosted job is a callable returning las::task <>, invoked with a hosted_job_token and its arguments.
+    /// A job function migrates from las::job by returning task <> and awaiting interval_wait. Sleeping jobs use no
+    /// thread, they are resumed by a timer wheel or by a stop request
+    class job_host : no_copy {
+    public:
+
+        /// job host constructor, starts the host threads
+        /// \param thread_count number of threads running jobs
+        /// \param resolution timer resolution, interval waits are rounded up to it
+        explicit job_host (std::size_t thread_count = 1, timer_wheel::duration resolution = std::chrono::milliseconds { 1 }) :
+            _dispatcher { thread_count },
+            _timer { resolution }
+        {}
+
+        /// stops every job and waits for them to return
+        ~job_host () {
+            stop ();
+
+            std::unique_lock lock (_jobs_lock);
+            _jobs_condition.wait (lock, [this]() { return _jobs.empty (); });
+        }
+
+        /// Start a job
+        /// \tparam call_t callable type, returning task <>
+        /// \tparam args_t arguments type vector
+        /// \param call job function, invoked with a hosted_job_token when it accepts one
+        /// \param args arguments, stored by value in the job's coroutine
+        /// \return handle to the job
+        template < typename call_t, typename ... args_t >
+        [[nodiscard]] hosted_job start (call_t && call, args_t && ... args) {
+            auto job = std::make_shared < details::hosted_job_state > (*this);
+
+            {
+                std::unique_lock const LOCK (_jobs_lock);
+                _jobs.push_back (job);
+            }
+
+            run_job < call_t, args_t... > (job, std::forward < call_t > (call), std::forward < args_t > (args)...);
+
+            return hosted_job { std::move (job) };
+        }
+
+        /// request every job to stop
+        void stop () {
+            std::vector < std::shared_ptr < details::hosted_job_state > > jobs;
+
+            {
+                std::unique_lock const LOCK (_jobs_lock);
+                jobs = _jobs;
+            }
+
+            for (auto const & job : jobs) {
+                job->state.request_stop ();
+            }
+        }
+
+        /// number of jobs that did not return
+        [[nodiscard]] std::size_t size () const {
+            std::unique_lock const LOCK (_jobs_lock);
+            return _jobs.size ();
+        }
+
+        /// number of threads running jobs
+        [[nodiscard]] std::size_t concurrency () const noexcept {
+            return _dispatcher.concurrency ();
+        }
+
+    private:
+        friend class details::hosted_job_state;
+
+        template < typename call_t, typename ... args_t >
+        details::detached_coroutine run_job (std::shared_ptr < details::hosted_job_state > job, std::decay_t < call_t > call, std::decay_t < args_t > ... args) {
+            co_await _dispatcher.schedule ();
+
+            hosted_job_token const TOKEN { *job };
+
+            if constexpr (std::is_invocable_v < decltype (call) &, hosted_job_token, decltype (args) &... >) {
+                co_await std::invoke (call, TOKEN, args...);
+            } else {
+                co_await std::invoke (call, args...);
+            }
+
+            finish_job (job);
+        }
+
+        void finish_job (std::shared_ptr < details::hosted_job_state > const & job) {
+            job->finish ();
+
+            // notified under the lock, the destructor may complete as soon as it is released
+            std::unique_lock const LOCK (_jobs_lock);
+
+            _jobs.erase (std::find (_jobs.begin (), _jobs.end (), job));
+            _jobs_condition.notify_all ();
+        }
+
+        async_dispatcher                _dispatcher;
+        timer_wheel                     _timer;
+
+        mutable std::mutex              _jobs_lock;
+        std::condition_variable         _jobs_condition;
+        std::vector < std::shared_ptr < details::hosted_job_state > >
+                                        _jobs;
+    };
+
+    namespace details {
+
+        inline void hosted_job_state::sleep_until (job_state::clock_type::time_point time_point, std::coroutine_handle <> handle) {
+            auto const NOW = job_state::clock_type::now ();
+
+            {
+                std::unique_lock const LOCK (_lock);
+
+                // a stop requested after this check finds the sleeping coroutine
+                if (time_point > NOW && !state.stop_requested ()) {
+                    _sleeping = handle;
+
+                    _timer = _host->_timer.schedule_after (_host->_dispatcher, time_point - NOW, [self = shared_from_this (), GENERATION = ++_generation]() {
+                        self->wake (GENERATION);
+                    });
+
+                    return;
+                }
+            }
+
+            resume (handle);
+        }
+
+        inline void hosted_job_state::wake (uint64_t generation) {
+            std::coroutine_handle <> handle;
+            timer_id timer {};
+
+            {
+                std::unique_lock const LOCK (_lock);
+
+                // not sleeping, or a late timer of an earlier sleep
+                if (!_sleeping || (generation != 0 && generation != _generation)) {
+                    return;
+                }
+
+                handle = std::exchange (_sleeping, {});
+                timer = std::exchange (_timer, {});
+            }
+
+            if (generation == 0) {
+                _host->_timer.cancel (timer);
+            }
+
+            resume (handle);
+        }
+
+        inline void hosted_job_state::resume (std::coroutine_handle <> handle) {
+            _host->_dispatcher.post ([handle]() mutable { handle.resume (); });
+        }
+
+    }
+
+}
+
+#endif
+
+#endif
@@ -10,11 +10,16 @@
 #include "debug_print.hpp"
 #include "details.hpp"
 #include "dispatcher.hpp"
+#include "dispatcher_metrics.hpp"
 #include "event.hpp"
+#include "event_count.hpp"
 #include "flag.hpp"
+#include "histogram.hpp"
 #include "ip_lock.hpp"
 #include "job.hpp"
+#include "job_host.hpp"
 #include "locked_value.hpp"
+#include "parallel.hpp"
 #include "ring_buffer.hpp"
 #include "scope_guards.hpp"
 #include "small_vector.hpp"
@@ -22,7 +27,11 @@
 #include "static_ring_buffer.hpp"
 #include "static_storage.hpp"
 #include "string.hpp"
+#include "task.hpp"
+#include "task_group.hpp"
+#include "timer_wheel.hpp"
 #include "traits.hpp"
 #include "view.hpp"
+#include "work_stealing_deque.hpp"
 
 #endif
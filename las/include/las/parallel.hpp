@@ -0,0 +1,320 @@
+#pragma once
+#ifndef LAS_PARALLEL_HPP
+#define LAS_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "las/dispatcher.hpp"
+#include "las/spin_mutex.hpp"
+#include "las/system.hpp"
+#include "las/view.hpp"
+
+namespace las {
+
+    /// grain value requesting the chunk size to be picked from the dispatcher's concurrency
+    constexpr std::size_t auto_grain { 0 };
+
+    namespace details {
+
+        /// chunks per participating thread when the grain is picked automatically
+        constexpr std::size_t auto_grain_chunks_per_thread { 4 };
+
+        /// shared state of a parallel loop
+        /// \note chunks are split recursively, the right half of every split is posted to the dispatcher
+        /// and the left half is processed by the splitting thread. Posted halves that were not picked up by
+        /// the time the splitting thread is done are executed by the splitting thread itself, so a loop always
+        /// completes even if the dispatcher never runs its tasks. A half the dispatcher fails to enqueue, such as on
+        /// a full bounded queue, is executed the same way
+        template < typename leaf_t >
+        struct parallel_state {
+        public:
+
+            struct split_node {
+                std::atomic_bool    claimed { false };
+                std::size_t         first { 0 };
+                std::size_t         last { 0 };
+
+                bool claim () noexcept {
+                    return !claimed.load (std::memory_order_relaxed) &&
+                           !claimed.exchange (true, std::memory_order_acquire);
+                }
+            };
+
+            parallel_state (std::size_t chunk_count, leaf_t leaf_v) :
+                CHUNK_COUNT { chunk_count },
+                leaf { std::move (leaf_v) },
+                _nodes { std::make_unique < split_node [] > (chunk_count) },
+                _remaining { static_cast < int32_t > (chunk_count) }
+            {}
+
+            /// process a range of chunks, splitting it while possible
+            static void run (dispatcher & target, std::shared_ptr < parallel_state > const & self, std::size_t first, std::size_t last) {
+                // at most one deferred split per halving level
+                split_node *    deferred [sizeof (std::size_t) * 8];
+                std::size_t     depth { 0 };
+                bool            can_post { true };
+
+                for (;;) {
+                    while (last - first > 1) {
+                        auto const MID = first + (last - first) / 2;
+                        auto * node = self->acquire_node (MID, last);
+
+                        if (can_post) {
+                            try {
+                                target.post ([self, node, &target]() {
+                                    if (node->claim ()) {
+                                        run (target, self, node->first, node->last);
+                                    }
+                                });
+                            } catch (...) {
+                                // left to the join below, leaving the loop before its posted halves are done
+                                // would let them outlive the caller's body. Later splits stay on this thread
+                                can_post = false;
+                            }
+                        }
+
+                        deferred [depth++] = node;
+                        last = MID;
+                    }
+
+                    self->execute (first);
+
+                    // join, run the halves nobody picked up
+                    split_node * resumed { nullptr };
+
+                    while (depth > 0 && !resumed) {
+                        auto * node = deferred [--depth];
+
+                        if (node->claim ()) {
+                            resumed = node;
+                        }
+                    }
+
+                    if (!resumed) {
+                        return;
+                    }
+
+                    first = resumed->first;
+                    last = resumed->last;
+                }
+            }
+
+            /// wait for every chunk to complete and rethrow the first captured exception
+            void wait () {
+                auto remaining = _remaining.atomic.load ();
+
+                while (remaining != 0) {
+                    futex_wait (&_remaining.integer, remaining);
+                    remaining = _remaining.atomic.load ();
+                }
+
+                if (_error) {
+                    std::rethrow_exception (_error);
+                }
+            }
+
+            std::size_t const   CHUNK_COUNT;
+            leaf_t              leaf;
+
+        private:
+
+            split_node * acquire_node (std::size_t first, std::size_t last) {
+                auto * node = &_nodes [_next_node.fetch_add (1, std::memory_order_relaxed)];
+
+                node->first = first;
+                node->last = last;
+
+                return node;
+            }
+
+            void execute (std::size_t chunk) noexcept {
+                if (!_failed.load (std::memory_order_relaxed)) {
+                    try {
+                        leaf (chunk);
+                    } catch (...) {
+                        std::unique_lock const LOCK (_error_lock);
+
+                        if (!_error) {
+                            _error = std::current_exception ();
+                            _failed.store (true, std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                if (_remaining.atomic.fetch_sub (1) == 1) {
+                    futex_wake_all (&_remaining.integer);
+                }
+            }
+
+            // a binary split tree over N chunks has N - 1 splits
+            std::unique_ptr < split_node [] >   _nodes;
+            std::atomic_size_t                  _next_node { 0 };
+
+            union {
+                std::atomic_int32_t atomic;
+                int32_t             integer;
+            } _remaining { 0 };
+
+            std::atomic_bool                    _failed { false };
+            spin_mutex                          _error_lock;
+            std::exception_ptr                  _error;
+        };
+
+        /// split [0, size) into chunks of at most grain elements
+        /// \return chunk size and count
+        inline std::pair < std::size_t, std::size_t > parallel_chunks (dispatcher const & target, std::size_t size, std::size_t grain) {
+            if (grain == auto_grain) {
+                auto const TARGET_CHUNKS = (target.concurrency () + 1) * auto_grain_chunks_per_thread;
+                grain = (size + TARGET_CHUNKS - 1) / TARGET_CHUNKS;
+            }
+
+            // chunk completion is tracked by a 32 bit futex counter
+            constexpr auto MAX_CHUNKS = static_cast < std::size_t > (std::numeric_limits < int32_t >::max ());
+
+            grain = std::max < std::size_t > ({ grain, 1, (size + MAX_CHUNKS - 1) / MAX_CHUNKS });
+
+            return { grain, (size + grain - 1) / grain };
+        }
+
+        /// run leaf for every chunk index in [0, chunk_count) on the dispatcher and the calling thread
+        template < typename leaf_t >
+        void parallel_run (dispatcher & target, std::size_t chunk_count, leaf_t && leaf) {
+            if (chunk_count == 0) {
+                return;
+            }
+
+            if (chunk_count == 1) {
+                leaf (0);
+                return;
+            }
+
+            using state_t = parallel_state < std::decay_t < leaf_t > >;
+
+            auto state = std::make_shared < state_t > (chunk_count, std::forward < leaf_t > (leaf));
+
+            state_t::run (target, state, 0, chunk_count);
+            state->wait ();
+        }
+
+    }
+
+    /// Execute a body over an index range, in parallel, using the dispatcher and the calling thread
+    /// \tparam index_t integral index type
+    /// \tparam body_t callable type with the signature <c>void (index_t begin, index_t end)</c>
+    /// \param target dispatcher used to execute chunks
+    /// \param begin first index
+    /// \param end index past the last
+    /// \param grain maximum number of indexes per chunk, or auto_grain
+    /// \param body callable executed for every chunk
+    /// \note returns only when every chunk completed, the first exception thrown by the body is rethrown
+    template < typename index_t, typename body_t >
+    void parallel_for (dispatcher & target, index_t begin, index_t end, std::size_t grain, body_t && body) {
+        static_assert (std::is_integral_v < index_t >, "parallel_for index must be an integral type");
+
+        if (end <= begin) {
+            return;
+        }
+
+        auto const SIZE = static_cast < std::size_t > (end - begin);
+        auto const [CHUNK_SIZE, CHUNK_COUNT] = details::parallel_chunks (target, SIZE, grain);
+
+        details::parallel_run (target, CHUNK_COUNT, [&body, begin, SIZE, CHUNK_SIZE = CHUNK_SIZE](std::size_t chunk) {
+            auto const FIRST = chunk * CHUNK_SIZE;
+            auto const LAST = std::min (FIRST + CHUNK_SIZE, SIZE);
+
+            body (static_cast < index_t > (begin + FIRST), static_cast < index_t > (begin + LAST));
+        });
+    }
+
+    /// Execute a body over a view, in parallel, using the dispatcher and the calling thread
+    /// \tparam value_t view value type
+    /// \tparam body_t callable type with the signature <c>void (las::view < value_t > chunk)</c>
+    /// \param target dispatcher used to execute chunks
+    /// \param range view to split into chunks
+    /// \param grain maximum number of elements per chunk, or auto_grain
+    /// \param body callable executed for every chunk
+    template < typename value_t, typename body_t >
+    void parallel_for (dispatcher & target, view < value_t > range, std::size_t grain, body_t && body) {
+        parallel_for (target, std::size_t { 0 }, range.size (), grain, [&body, range](std::size_t first, std::size_t last) {
+            body (view < value_t > { range.data () + first, last - first });
+        });
+    }
+
+    /// Reduce an index range, in parallel, using the dispatcher and the calling thread
+    /// \tparam index_t integral index type
+    /// \tparam value_t reduction value type
+    /// \tparam body_t callable type with the signature <c>value_t (index_t begin, index_t end)</c>
+    /// \tparam reduce_t callable type with the signature <c>value_t (value_t lhv, value_t rhv)</c>
+    /// \param target dispatcher used to execute chunks
+    /// \param begin first index
+    /// \param end index past the last
+    /// \param grain maximum number of indexes per chunk, or auto_grain
+    /// \param identity reduction identity value
+    /// \param body callable reducing a chunk
+    /// \param reduce associative callable combining two reduced values
+    /// \return the reduced value
+    /// \note chunk results are combined in index order, reduce does not need to be commutative
+    template < typename index_t, typename value_t, typename body_t, typename reduce_t >
+    value_t parallel_reduce (dispatcher & target, index_t begin, index_t end, std::size_t grain, value_t identity, body_t && body, reduce_t && reduce) {
+        static_assert (std::is_integral_v < index_t >, "parallel_reduce index must be an integral type");
+
+        if (end <= begin) {
+            return identity;
+        }
+
+        auto const SIZE = static_cast < std::size_t > (end - begin);
+        auto const [CHUNK_SIZE, CHUNK_COUNT] = details::parallel_chunks (target, SIZE, grain);
+
+        std::vector < value_t > results (CHUNK_COUNT, identity);
+
+        details::parallel_run (target, CHUNK_COUNT, [&body, &results, begin, SIZE, CHUNK_SIZE = CHUNK_SIZE](std::size_t chunk) {
+            auto const FIRST = chunk * CHUNK_SIZE;
+            auto const LAST = std::min (FIRST + CHUNK_SIZE, SIZE);
+
+            results [chunk] = body (static_cast < index_t > (begin + FIRST), static_cast < index_t > (begin + LAST));
+        });
+
+        for (auto & result : results) {
+            identity = reduce (std::move (identity), std::move (result));
+        }
+
+        return identity;
+    }
+
+    /// Reduce a view, in parallel, using the dispatcher and the calling thread
+    /// \tparam value_t view value type
+    /// \tparam result_t reduction value type
+    /// \tparam body_t callable type with the signature <c>result_t (las::view < value_t > chunk)</c>
+    /// \tparam reduce_t callable type with the signature <c>result_t (result_t lhv, result_t rhv)</c>
+    /// \param target dispatcher used to execute chunks
+    /// \param range view to split into chunks
+    /// \param grain maximum number of elements per chunk, or auto_grain
+    /// \param identity reduction identity value
+    /// \param body callable reducing a chunk
+    /// \param reduce associative callable combining two reduced values
+    /// \return the reduced value
+    template < typename value_t, typename result_t, typename body_t, typename reduce_t >
+    result_t parallel_reduce (dispatcher & target, view < value_t > range, std::size_t grain, result_t identity, body_t && body, reduce_t && reduce) {
+        return parallel_reduce (
+                target,
+                std::size_t { 0 },
+                range.size (),
+                grain,
+                std::move (identity),
+                [&body, range](std::size_t first, std::size_t last) {
+                    return body (view < value_t > { range.data () + first, last - first });
+                },
+                std::forward < reduce_t > (reduce));
+    }
+
+}
+
+#endif
@@ -312,7 +312,7 @@ namespace las {
             auto new_begin = _impl.allocate(n);
             auto data_size = size();
 
-            if (std::is_trivially_copyable_v < value_type >) {
+            if constexpr (std::is_trivially_copyable_v < value_type >) {
                 range_copy(new_begin);
                 range_destroy();
             } else {
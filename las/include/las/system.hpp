@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <limits>
 #include <optional>
+#include <string_view>
 #include <thread>
 #include <type_traits>
 #include <vector>
@@ -63,6 +64,18 @@ namespace las {
     /// \return vector of core id
     std::vector < core_id_t > physical_cores ();
 
+    /// NUMA node id type
+    using numa_node_t = std::size_t;
+
+    /// Get the cores of each NUMA node
+    /// \return core ids of each node, indexed by node id. Empty if the NUMA topology is not available
+    std::vector < std::vector < core_id_t > > numa_nodes ();
+
+    /// Parse a cpu list, as used by linux sysfs (ex: "0-3,8,10-11")
+    /// \param list cpu list text
+    /// \return sorted core ids, nullopt if the list is malformed
+    std::optional < std::vector < core_id_t > > cpu_list_parse (std::string_view list);
+
     /// Get the native handle for the calling thread
     inline std::thread::native_handle_type this_thread_native_handle ();
 
@@ -160,7 +173,10 @@ namespace las {
 
 #if defined (LAS_OS_WINDOWS)
     inline futex_wait_result futex_wait (futex_value_t* address, futex_value_t expected_value, std::chrono::milliseconds TIMEOUT) noexcept {
-		return WaitOnAddress(address, &expected_value, sizeof(futex_value_t), TIMEOUT.count()) == TRUE ?
+        // as on linux, a zero timeout waits without a timeout, WaitOnAddress would return immediately
+        auto const WAIT_MS = (TIMEOUT == std::chrono::milliseconds::zero () ? INFINITE : static_cast < DWORD > (TIMEOUT.count ()));
+
+		return WaitOnAddress(address, &expected_value, sizeof(futex_value_t), WAIT_MS) == TRUE ?
             futex_wait_result::awake :
             futex_wait_result::timeout;
     }
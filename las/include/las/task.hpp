@@ -0,0 +1,256 @@
+#pragma once
+#ifndef LAS_TASK_HPP
+#define LAS_TASK_HPP
+
+#include "las/config.hpp"
+
+#if defined (LAS_HAS_COROUTINES)
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "las/debug.hpp"
+#include "las/details.hpp"
+#include "las/dispatcher.hpp"
+
+namespace las {
+
+    template < typename value_t = void >
+    class task;
+
+    namespace details {
+
+        /// resumes the awaiting coroutine once a task completes
+        struct task_final_awaitable {
+            [[nodiscard]] constexpr bool await_ready () const noexcept {
+                return false;
+            }
+
+            template < typename promise_t >
+            std::coroutine_handle <> await_suspend (std::coroutine_handle < promise_t > handle) noexcept {
+                auto continuation = handle.promise ().continuation;
+                return continuation ? continuation : std::noop_coroutine ();
+            }
+
+            constexpr void await_resume () const noexcept {}
+        };
+
+        /// task promise state shared by every result type
+        struct task_promise_base {
+            std::coroutine_handle <>    continuation {};
+
+            [[nodiscard]] std::suspend_always initial_suspend () const noexcept {
+                return {};
+            }
+
+            [[nodiscard]] task_final_awaitable final_suspend () const noexcept {
+                return {};
+            }
+        };
+
+        template < typename value_t >
+        struct task_promise : task_promise_base {
+        public:
+            task < value_t > get_return_object () noexcept;
+
+            template < typename result_t >
+            void return_value (result_t && result) {
+                _result.template emplace < 1 > (std::forward < result_t > (result));
+            }
+
+            void unhandled_exception () noexcept {
+                _result.template emplace < 2 > (std::current_exception ());
+            }
+
+            value_t result () {
+                if (_result.index () == 2) {
+                    std::rethrow_exception (std::get < 2 > (_result));
+                }
+
+                return std::move (std::get < 1 > (_result));
+            }
+
+        private:
+            std::variant < std::monostate, value_t, std::exception_ptr > _result;
+        };
+
+        template <>
+        struct task_promise < void > : task_promise_base {
+        public:
+            task < void > get_return_object () noexcept;
+
+            void return_void () noexcept {}
+
+            void unhandled_exception () noexcept {
+                _exception = std::current_exception ();
+            }
+
+            void result () {
+                if (_exception) {
+                    std::rethrow_exception (_exception);
+                }
+            }
+
+        private:
+            std::exception_ptr _exception;
+        };
+
+        /// eagerly started coroutine, destroyed on completion
+        struct detached_coroutine {
+            struct promise_type {
+                detached_coroutine get_return_object () noexcept { return {}; }
+
+                [[nodiscard]] std::suspend_never initial_suspend () const noexcept { return {}; }
+                [[nodiscard]] std::suspend_never final_suspend () const noexcept { return {}; }
+
+                void return_void () noexcept {}
+
+                void unhandled_exception () noexcept {
+                    std::terminate ();
+                }
+            };
+        };
+
+    }
+
+    /// Lazily started coroutine producing a value
+    /// \tparam value_t result type, void for no result
+    /// \note the coroutine starts when awaited and the awaiting coroutine resumes, without scheduling, on the thread
+    /// that completed the task. Use `co_await dispatcher.schedule ()` to move the coroutine to a dispatcher
+    template < typename value_t >
+    class task : no_copy {
+    public:
+
+        static_assert (!std::is_reference_v < value_t >, "task results are stored by value");
+
+        using promise_type = details::task_promise < value_t >;
+        using handle_type = std::coroutine_handle < promise_type >;
+
+        task () noexcept = default;
+
+        explicit task (handle_type handle) noexcept :
+            _handle { handle }
+        {}
+
+        task (task && other) noexcept :
+            _handle { std::exchange (other._handle, {}) }
+        {}
+
+        task & operator = (task && other) noexcept {
+            if (this != &other) {
+                reset ();
+                _handle = std::exchange (other._handle, {});
+            }
+
+            return *this;
+        }
+
+        ~task () {
+            reset ();
+        }
+
+        /// check if the task holds a coroutine
+        [[nodiscard]] bool valid () const noexcept {
+            return static_cast < bool > (_handle);
+        }
+
+        /// check if the coroutine has completed
+        [[nodiscard]] bool done () const noexcept {
+            return !_handle || _handle.done ();
+        }
+
+        /// Start the coroutine and suspend the awaiting coroutine until it completes
+        /// \return the coroutine's result, rethrows its exception
+        auto operator co_await () && noexcept {
+            struct awaitable {
+                handle_type handle;
+
+                [[nodiscard]] bool await_ready () const noexcept {
+                    return !handle || handle.done ();
+                }
+
+                std::coroutine_handle <> await_suspend (std::coroutine_handle <> awaiting) noexcept {
+                    handle.promise ().continuation = awaiting;
+                    return handle;
+                }
+
+                value_t await_resume () {
+                    if (!handle) {
+                        LAS_DEBUG_BREAK(); // Awaiting an empty task!
+                        throw std::future_error (std::future_errc::no_state);
+                    }
+
+                    return handle.promise ().result ();
+                }
+            };
+
+            return awaitable { _handle };
+        }
+
+    private:
+
+        void reset () noexcept {
+            if (_handle) {
+                _handle.destroy ();
+                _handle = {};
+            }
+        }
+
+        handle_type _handle {};
+    };
+
+    namespace details {
+
+        template < typename value_t >
+        task < value_t > task_promise < value_t >::get_return_object () noexcept {
+            return task < value_t > { std::coroutine_handle < task_promise >::from_promise (*this) };
+        }
+
+        inline task < void > task_promise < void >::get_return_object () noexcept {
+            return task < void > { std::coroutine_handle < task_promise >::from_promise (*this) };
+        }
+
+        template < typename value_t >
+        detached_coroutine run_detached (dispatcher & owner, task < value_t > work, std::promise < value_t > result) {
+            try {
+                co_await owner.schedule ();
+
+                if constexpr (std::is_void_v < value_t >) {
+                    co_await std::move (work);
+                    result.set_value ();
+                } else {
+                    result.set_value (co_await std::move (work));
+                }
+            } catch (...) {
+                result.set_exception (std::current_exception ());
+            }
+        }
+
+    }
+
+    /// Start a task on a dispatcher
+    /// \tparam value_t task result type
+    /// \param owner dispatcher the task starts on
+    /// \param work task to start
+    /// \return future for the task's result or exception
+    /// \note bridges synchronous code into coroutines, awaiting tasks from other tasks allocates no future state.
+    /// Waiting on the future from the thread dispatching a sync_dispatcher will never complete
+    template < typename value_t >
+    [[nodiscard]] std::future < value_t > spawn (dispatcher & owner, task < value_t > work) {
+        std::promise < value_t > result;
+        auto future = result.get_future ();
+
+        details::run_detached (owner, std::move (work), std::move (result));
+
+        return future;
+    }
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,90 @@
+#pragma once
+#ifndef LAS_TASK_GROUP_HPP
+#define LAS_TASK_GROUP_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+
+#include "las/details.hpp"
+#include "las/dispatcher.hpp"
+#include "las/scope_guards.hpp"
+#include "las/spin_mutex.hpp"
+
+namespace las {
+
+    /// Tracks a set of tasks enqueued to a dispatcher
+    /// \note tasks are tracked with a single atomic counter, no per task future is created
+    class task_group : no_copy {
+    public:
+
+        /// task group constructor
+        /// \param target dispatcher used to execute the group's tasks
+        explicit task_group (dispatcher & target);
+
+        /// waits for every task of the group
+        ~task_group ();
+
+        /// Run a task as part of the group
+        /// \tparam func_t callable type
+        /// \param func callable object without arguments
+        /// \note tasks started after the group is cancelled are skipped. If the dispatcher fails to enqueue the
+        /// task, its exception propagates and the task is not part of the group
+        template < typename func_t >
+        void run (func_t && func) {
+            _pending.atomic.fetch_add (1, std::memory_order_relaxed);
+
+            // a task that was never enqueued would keep wait from returning
+            auto const UNDO = scope_fail ([this] { complete_one (); });
+
+            _target.post ([this, call = std::forward < func_t > (func)]() mutable {
+                if (!is_cancelled ()) {
+                    try {
+                        call ();
+                    } catch (...) {
+                        capture_exception (std::current_exception ());
+                    }
+                }
+
+                complete_one ();
+            });
+        }
+
+        /// Wait for every task of the group to complete
+        /// \note the calling thread executes pending dispatcher tasks while waiting, this may execute tasks of other
+        /// groups. A sync_dispatcher is only helped from a thread dispatching it, other threads block until the
+        /// dispatching thread runs the group's tasks. The first exception thrown by a task of the group is rethrown,
+        /// once it is, the group can be reused
+        void wait ();
+
+        /// Cancel every task of the group that has not started yet
+        void cancel () noexcept;
+
+        /// Check if the group was cancelled, either explicitly or by a task exception
+        [[nodiscard]] bool is_cancelled () const noexcept;
+
+        /// Number of tasks of the group not yet completed
+        [[nodiscard]] std::size_t pending () const noexcept;
+
+    private:
+
+        void capture_exception (std::exception_ptr error) noexcept;
+
+        void complete_one () noexcept;
+
+        dispatcher &        _target;
+
+        union {
+            std::atomic_int32_t atomic;
+            int32_t             integer;
+        } _pending { 0 };
+
+        std::atomic_bool    _cancelled { false };
+
+        spin_mutex          _error_lock;
+        std::exception_ptr  _error;
+    };
+
+}
+
+#endif
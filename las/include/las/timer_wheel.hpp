@@ -0,0 +1,152 @@
+#pragma once
+#ifndef LAS_TIMER_WHEEL_HPP
+#define LAS_TIMER_WHEEL_HPP
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "las/details.hpp"
+#include "las/dispatcher.hpp"
+
+namespace las {
+
+    /// Identifies a timer scheduled in a timer_wheel
+    struct timer_id {
+        uint32_t index { 0 };
+        uint32_t generation { 0 };
+
+        /// check if the id refers to a scheduled timer (it may have expired since)
+        explicit operator bool () const noexcept { return generation != 0; }
+    };
+
+    /// Hierarchical timer wheel, schedules delayed and periodic tasks onto dispatchers
+    /// \note a single timer thread serves every timer. Insertion and cancellation are O(1), expired tasks are
+    /// posted to their dispatcher, which must outlive the timer. Timers are rounded up to the wheel resolution
+    class timer_wheel : no_copy {
+    public:
+
+        using clock_type = std::chrono::steady_clock;
+        using duration = clock_type::duration;
+
+        /// slots per wheel level
+        static constexpr std::size_t slot_count { 64 };
+
+        /// number of wheel levels, delays beyond slot_count ^ level_count ticks are cascaded again when reached
+        static constexpr std::size_t level_count { 4 };
+
+        /// timer wheel constructor, starts the timer thread
+        /// \param resolution duration of a wheel tick
+        explicit timer_wheel (duration resolution = std::chrono::milliseconds { 1 });
+
+        /// stops the timer thread, pending timers are dropped
+        ~timer_wheel ();
+
+        /// Schedule a task to be posted once after a delay
+        /// \tparam func_t callable type
+        /// \param target dispatcher executing the task
+        /// \param delay time to wait before posting the task
+        /// \param func callable object without arguments
+        /// \return id of the timer, usable to cancel it
+        template < typename func_t >
+        timer_id schedule_after (dispatcher & target, duration delay, func_t && func) {
+            return schedule (target, delay, duration::zero (), dispatcher::task_proxy::make (std::forward < func_t > (func)));
+        }
+
+        /// Schedule a task to be posted periodically
+        /// \tparam func_t callable type
+        /// \param target dispatcher executing the task
+        /// \param period time between two posts of the task, the first post happens after one period
+        /// \param func callable object without arguments
+        /// \return id of the timer, usable to cancel it
+        /// \note expirations are computed from the schedule time and do not drift. A task still running when the next
+        /// period expires is posted again
+        template < typename func_t >
+        timer_id schedule_every (dispatcher & target, duration period, func_t && func) {
+            return schedule (target, period, period, dispatcher::task_proxy::make (std::forward < func_t > (func)));
+        }
+
+        /// Cancel a scheduled timer
+        /// \param id timer to cancel
+        /// \return true if the timer was cancelled, false if it already expired or was cancelled before
+        /// \note a task already posted to its dispatcher is not recalled
+        bool cancel (timer_id id);
+
+        /// stop the timer thread
+        /// \note automatically called by the destructor
+        void stop ();
+
+        /// number of scheduled timers
+        [[nodiscard]] std::size_t size () const;
+
+        /// duration of a wheel tick
+        [[nodiscard]] duration resolution () const noexcept { return RESOLUTION; }
+
+    private:
+
+        static constexpr uint32_t npos { ~uint32_t { 0 } };
+
+        struct timer_entry {
+            dispatcher::task_proxy                      task;
+            std::shared_ptr < dispatcher::task_proxy >  repeat_task;
+            dispatcher *                                target { nullptr };
+            uint64_t                                    expiry { 0 };
+            uint64_t                                    period { 0 };
+            uint32_t                                    generation { 1 };
+            uint32_t                                    prev { npos };
+            uint32_t                                    next { npos };
+            uint32_t                                    slot { npos };
+        };
+
+        struct fired_task {
+            dispatcher *            target;
+            dispatcher::task_proxy  task;
+        };
+
+        timer_id schedule (dispatcher & target, duration delay, duration period, dispatcher::task_proxy && task);
+
+        void timer_loop ();
+
+        [[nodiscard]] uint64_t elapsed_ticks (clock_type::time_point time) const noexcept;
+        [[nodiscard]] uint64_t to_ticks (duration span) const noexcept;
+        [[nodiscard]] uint64_t next_event_tick () const noexcept;
+
+        void advance_to (uint64_t tick);
+        void cascade (std::size_t level);
+        void expire_slot ();
+
+        void link (uint32_t index);
+        void unlink (uint32_t index) noexcept;
+        void release (uint32_t index) noexcept;
+
+        duration const                  RESOLUTION;
+        clock_type::time_point const    START;
+
+        mutable std::mutex              _mutex;
+        std::condition_variable         _wake_condition;
+
+        std::vector < timer_entry >     _entries;
+        uint32_t                        _free_head { npos };
+        std::size_t                     _active_count { 0 };
+
+        std::array < uint32_t, slot_count * level_count >
+                                        _slots;
+        std::array < uint64_t, level_count >
+                                        _occupied {};
+
+        uint64_t                        _now { 0 };
+        uint64_t                        _wake_tick { 0 };
+        bool                            _is_running { true };
+
+        std::vector < fired_task >      _fired;
+        std::thread                     _thread;
+    };
+
+}
+
+#endif
@@ -0,0 +1,181 @@
+#pragma once
+#ifndef LAS_WORK_STEALING_DEQUE_HPP
+#define LAS_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "las/bits.hpp"
+#include "las/details.hpp"
+
+namespace las {
+
+    /// Chase-Lev work stealing deque
+    /// \tparam value_t stored value type, must be trivially copyable (usually a pointer)
+    /// \note push and pop are reserved to the owning thread, steal can be called from any thread.
+    /// Implementation follows "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.)
+    template < typename value_t >
+    struct work_stealing_deque : no_copy {
+    public:
+
+        static_assert (std::is_trivially_copyable_v < value_t >, "work_stealing_deque supports only trivially copyable types");
+
+        using value_type = value_t;
+        using index_type = std::int64_t;
+
+        /// deque constructor
+        /// \param capacity initial capacity, rounded up to the next power of two
+        explicit work_stealing_deque (std::size_t capacity = default_capacity) :
+            _buffer { new buffer (next_pow_2 (capacity < 2 ? std::size_t { 2 } : capacity)) }
+        {}
+
+        ~work_stealing_deque () {
+            delete _buffer.load (std::memory_order_relaxed);
+        }
+
+        /// push a value to the bottom of the deque
+        /// \param value the value to push
+        /// \note owner thread only
+        void push (value_type value) {
+            auto const BOTTOM = _bottom.load (std::memory_order_relaxed);
+            auto const TOP = _top.load (std::memory_order_acquire);
+            auto * buf = _buffer.load (std::memory_order_relaxed);
+
+            if (BOTTOM - TOP > buf->capacity () - 1) {
+                buf = grow (buf, TOP, BOTTOM);
+            }
+
+            buf->store (BOTTOM, value);
+
+            // publish the value to thieves
+            _bottom.store (BOTTOM + 1, std::memory_order_release);
+        }
+
+        /// pop a value from the bottom of the deque (LIFO)
+        /// \return the popped value or nullopt if the deque is empty
+        /// \note owner thread only
+        std::optional < value_type > pop () {
+            auto const BOTTOM = _bottom.load (std::memory_order_relaxed) - 1;
+            auto * buf = _buffer.load (std::memory_order_relaxed);
+
+            // bottom store and top load must not be reordered, seq_cst
+            // operations keep that order (same as a full fence)
+            _bottom.store (BOTTOM, std::memory_order_seq_cst);
+
+            auto top = _top.load (std::memory_order_seq_cst);
+
+            if (top > BOTTOM) {
+                // deque was empty, restore bottom
+                _bottom.store (BOTTOM + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            std::optional < value_type > value { buf->load (BOTTOM) };
+
+            if (top == BOTTOM) {
+                // last item, race against thieves
+                if (!_top.compare_exchange_strong (top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    value.reset ();
+                }
+
+                _bottom.store (BOTTOM + 1, std::memory_order_relaxed);
+            }
+
+            return value;
+        }
+
+        /// steal a value from the top of the deque (FIFO)
+        /// \return the stolen value or nullopt if the deque is empty or the steal lost a race
+        /// \note can be called from any thread
+        std::optional < value_type > steal () {
+            auto top = _top.load (std::memory_order_seq_cst);
+            auto const BOTTOM = _bottom.load (std::memory_order_seq_cst);
+
+            if (top >= BOTTOM) {
+                return std::nullopt;
+            }
+
+            auto * buf = _buffer.load (std::memory_order_acquire);
+            auto const VALUE = buf->load (top);
+
+            if (!_top.compare_exchange_strong (top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return std::nullopt;
+            }
+
+            return VALUE;
+        }
+
+        /// approximate number of values in the deque
+        [[nodiscard]] std::size_t size () const noexcept {
+            auto const BOTTOM = _bottom.load (std::memory_order_relaxed);
+            auto const TOP = _top.load (std::memory_order_relaxed);
+
+            return BOTTOM > TOP ? static_cast < std::size_t > (BOTTOM - TOP) : 0;
+        }
+
+        /// check if the deque is (approximately) empty
+        [[nodiscard]] bool empty () const noexcept {
+            return size () == 0;
+        }
+
+        /// current buffer capacity
+        [[nodiscard]] std::size_t capacity () const noexcept {
+            return static_cast < std::size_t > (_buffer.load (std::memory_order_relaxed)->capacity ());
+        }
+
+        static constexpr std::size_t default_capacity { 256 };
+
+    private:
+
+        struct buffer {
+        public:
+
+            explicit buffer (std::size_t capacity_v) :
+                MASK { static_cast < index_type > (capacity_v - 1) },
+                _slots { std::make_unique < std::atomic < value_type > [] > (capacity_v) }
+            {}
+
+            [[nodiscard]] index_type capacity () const noexcept { return MASK + 1; }
+
+            void store (index_type index, value_type value) noexcept {
+                _slots [index & MASK].store (value, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] value_type load (index_type index) const noexcept {
+                return _slots [index & MASK].load (std::memory_order_relaxed);
+            }
+
+        private:
+            index_type const                                MASK;
+            std::unique_ptr < std::atomic < value_type > [] > _slots;
+        };
+
+        buffer * grow (buffer * origin, index_type top, index_type bottom) {
+            auto * new_buffer = new buffer (static_cast < std::size_t > (origin->capacity ()) * 2);
+
+            for (auto i = top; i < bottom; ++i) {
+                new_buffer->store (i, origin->load (i));
+            }
+
+            // thieves may still be reading from the old buffer, so it is retired
+            // and only released when the deque itself is destroyed
+            _retired.emplace_back (origin);
+            _buffer.store (new_buffer, std::memory_order_release);
+
+            return new_buffer;
+        }
+
+        alignas (64) std::atomic < index_type >     _top { 0 };
+        alignas (64) std::atomic < index_type >     _bottom { 0 };
+        alignas (64) std::atomic < buffer * >       _buffer;
+
+        std::vector < std::unique_ptr < buffer > >  _retired;
+    };
+
+}
+
+#endif
@@ -1,63 +1,589 @@
 #include "las/dispatcher.hpp"
+#include "las/atomic_details.hpp"
 #include "las/debug.hpp"
 #include "las/locked_value.hpp"
+#include "las/scope_guards.hpp"
+#include "las/system.hpp"
+#include "las/work_stealing_deque.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <immintrin.h>
+#include <system_error>
+#include <utility>
 
 namespace las {
 
+    namespace details {
+
+        /// task wrapper for containers that reference tasks by pointer
+        struct task_node {
+            dispatcher::task_proxy  task;
+            task_node *             next { nullptr };
+        };
+
+    }
+
+    namespace {
+
+        using details::task_node;
+
+        /// per thread cache of released task nodes, avoids a heap allocation per task
+        /// once the cache is warm
+        struct task_node_cache : no_copy {
+        public:
+
+            ~task_node_cache () {
+                while (_head) {
+                    delete std::exchange (_head, _head->next);
+                }
+            }
+
+            /// \param reserve shared list of released nodes, adopted at once when the cache is empty
+            task_node * acquire (dispatcher::task_proxy && task, std::atomic < task_node * > * reserve = nullptr) {
+                if (!_head && reserve) {
+                    adopt (atomic_details::atomic_detach (*reserve));
+                }
+
+                if (!_head) {
+                    return new task_node { std::move (task) };
+                }
+
+                auto * node = std::exchange (_head, _head->next);
+                --_count;
+
+                node->task = std::move (task);
+                node->next = nullptr;
+
+                return node;
+            }
+
+            void release (task_node * node) noexcept {
+                node->task.reset ();
+
+                if (_count >= capacity) {
+                    delete node;
+                    return;
+                }
+
+                node->next = _head;
+                _head = node;
+                ++_count;
+            }
+
+            static constexpr std::size_t capacity { 1024 };
+
+        private:
+
+            /// takes released nodes up to capacity, the surplus is freed
+            void adopt (task_node * chain) noexcept {
+                while (chain) {
+                    auto * node = std::exchange (chain, chain->next);
+
+                    if (_count >= capacity) {
+                        delete node;
+                        continue;
+                    }
+
+                    node->next = _head;
+                    _head = node;
+                    ++_count;
+                }
+            }
+
+            task_node *     _head { nullptr };
+            std::size_t     _count { 0 };
+        };
+
+        thread_local task_node_cache node_cache;
+
+        /// sync dispatcher being dispatched by the calling thread, linked to the frames it is nested in
+        struct dispatch_frame {
+            sync_dispatcher const * owner;
+            dispatch_frame const *  outer;
+        };
+
+        thread_local dispatch_frame const * this_dispatch_frame { nullptr };
+
+        /// register the calling thread as dispatching a sync dispatcher for the guard's lifetime
+        auto enter_dispatch_frame (dispatch_frame & frame) noexcept {
+            frame.outer = std::exchange (this_dispatch_frame, &frame);
+            return scope_exit ([&frame] { this_dispatch_frame = frame.outer; });
+        }
+
+        /// task wrapper recording queue wait and execution times
+        struct instrumented_task {
+        public:
+            using clock_type = dispatcher_metrics::clock_type;
+
+            instrumented_task (task_node * node_v, dispatcher_metrics & metrics_ref) :
+                node { node_v },
+                metrics { &metrics_ref },
+                enqueue_time { clock_type::now () }
+            {}
+
+            instrumented_task (instrumented_task && other) noexcept :
+                node { std::exchange (other.node, nullptr) },
+                metrics { other.metrics },
+                enqueue_time { other.enqueue_time }
+            {}
+
+            instrumented_task (instrumented_task const &) = delete;
+            instrumented_task & operator = (instrumented_task const &) = delete;
+            instrumented_task & operator = (instrumented_task &&) = delete;
+
+            ~instrumented_task () {
+                // dropped without execution
+                if (node) {
+                    metrics->on_dequeue ();
+                    node_cache.release (node);
+                }
+            }
+
+            void operator () () {
+                if (!node) {
+                    return;
+                }
+
+                auto * const task = std::exchange (node, nullptr);
+                auto const START = clock_type::now ();
+
+                metrics->on_dequeue ();
+
+                auto const RECORD = [&] {
+                    metrics->on_execute (START - enqueue_time, clock_type::now () - START);
+                    node_cache.release (task);
+                };
+
+                try {
+                    task->task.invoke ();
+                } catch (...) {
+                    RECORD ();
+                    throw;
+                }
+
+                RECORD ();
+            }
+
+        private:
+            task_node *             node;
+            dispatcher_metrics *    metrics;
+            clock_type::time_point  enqueue_time;
+        };
+
+        /// append a chain of queued tasks, most recent first, to a list in enqueue order
+        void append_in_order (task_node * chain, task_node * & head, task_node * & tail) noexcept {
+            if (!chain) {
+                return;
+            }
+
+            // reverse into enqueue order, the most recent task becomes the tail
+            auto * const CHAIN_TAIL = chain;
+            task_node * chain_head { nullptr };
+
+            while (chain) {
+                auto * next = chain->next;
+                chain->next = chain_head;
+                chain_head = chain;
+                chain = next;
+            }
+
+            if (tail) {
+                tail->next = chain_head;
+            } else {
+                head = chain_head;
+            }
+
+            tail = CHAIN_TAIL;
+        }
+
+        constexpr std::size_t lane_index (task_priority priority) noexcept {
+            return static_cast < std::size_t > (priority);
+        }
+
+        /// core and NUMA node of each worker, packed node by node
+        /// \return placement of each worker, empty if the cpu topology is not available
+        std::vector < std::pair < core_id_t, numa_node_t > > worker_placement (async_dispatcher_options const & options) {
+            std::vector < core_id_t > cores;
+            std::vector < std::vector < core_id_t > > nodes;
+
+            try {
+                if (options.skip_smt_siblings) {
+                    cores = physical_cores ();
+                } else {
+                    for (core_id_t core = 0; core < std::thread::hardware_concurrency (); ++core) {
+                        cores.push_back (core);
+                    }
+                }
+
+                if (options.numa_aware) {
+                    nodes = numa_nodes ();
+                }
+            } catch (std::exception const &) {
+                // unknown topology, workers are not pinned
+                return {};
+            }
+
+            auto const NODE_OF = [&nodes](core_id_t core) {
+                for (numa_node_t node = 0; node < nodes.size (); ++node) {
+                    if (std::binary_search (nodes [node].begin (), nodes [node].end (), core)) {
+                        return node;
+                    }
+                }
+
+                return numa_node_t { 0 };
+            };
+
+            std::vector < std::pair < core_id_t, numa_node_t > > cores_by_node;
+
+            for (auto core : cores) {
+                cores_by_node.emplace_back (core, NODE_OF (core));
+            }
+
+            std::stable_sort (cores_by_node.begin (), cores_by_node.end (), [](auto const & lhv, auto const & rhv) {
+                return lhv.second < rhv.second;
+            });
+
+            if (cores_by_node.empty ()) {
+                return {};
+            }
+
+            // more workers than cores wrap around
+            std::vector < std::pair < core_id_t, numa_node_t > > placement;
+
+            for (std::size_t i = 0; i < options.thread_count; ++i) {
+                placement.push_back (cores_by_node [i % cores_by_node.size ()]);
+            }
+
+            return placement;
+        }
+
+    }
+
+    void dispatcher::enable_metrics() {
+        std::unique_lock const LOCK (_metrics_lock);
+
+        if (!_metrics_owner) {
+            _metrics_owner = std::make_unique < dispatcher_metrics > ();
+            _metrics.store (_metrics_owner.get (), std::memory_order_release);
+        }
+    }
+
+    dispatcher_metrics_snapshot dispatcher::metrics() const {
+        auto const * metrics = metrics_recorder ();
+
+        if (!metrics) {
+            return {};
+        }
+
+        auto snapshot = metrics->snapshot ();
+        collect_metrics (snapshot);
+
+        return snapshot;
+    }
+
+    void dispatcher::instrument(dispatcher_metrics & metrics, task_proxy & proxy) {
+        metrics.on_enqueue (1);
+        proxy = task_proxy::make (instrumented_task { node_cache.acquire (std::move (proxy)), metrics });
+    }
+
+    sync_dispatcher::~sync_dispatcher() {
+        for (auto * chain : { _queued_tasks.load (), _free_nodes.load (), _ready_head }) {
+            while (chain) {
+                delete std::exchange (chain, chain->next);
+            }
+        }
+    }
+
     bool sync_dispatcher::is_done() const {
-        auto locked_tasks = _queued_tasks.shared ();
-        return locked_tasks.value ().empty();
+        if (_queued_tasks.load (std::memory_order_acquire)) {
+            return false;
+        }
+
+        std::unique_lock const LOCK (_ready_lock);
+        return _ready_head == nullptr;
     }
 
     void sync_dispatcher::dispatch() {
-        auto locked_exec = _exec_tasks.unique(std::defer_lock);
-
-        if (!locked_exec.lock ().try_lock()) {
-            LAS_DEBUG_BREAK(); // Dispatch called as consequence of dispatched task unsupported. Call ignored!
-            return;
+        {
+            std::unique_lock const LOCK (_ready_lock);
+            refill_ready_tasks ();
         }
 
+        // tasks enqueued from now on wait for the next dispatch
+        run_ready_tasks (false, {});
+    }
+
+    std::size_t sync_dispatcher::drain(dispatch_budget const & budget) {
+        return run_ready_tasks (true, budget);
+    }
+
+    dispatch_result sync_dispatcher::dispatch_for(std::chrono::nanoseconds budget) {
         {
-            auto locked_queue = _queued_tasks.unique();
-            std::swap (locked_exec.value (), locked_queue.value ());
+            std::unique_lock const LOCK (_ready_lock);
+            refill_ready_tasks ();
+        }
+
+        dispatch_budget limits;
+        limits.max_time = budget;
+
+        auto const EXECUTED = run_ready_tasks (false, limits);
+
+        return { EXECUTED, pending () };
+    }
+
+    std::size_t sync_dispatcher::pending() const noexcept {
+        return _pending.load (std::memory_order_relaxed);
+    }
+
+    std::size_t sync_dispatcher::run_ready_tasks(bool should_refill, dispatch_budget const & budget) {
+        using clock = std::chrono::steady_clock;
+
+        bool const IS_TIMED = budget.max_time != std::chrono::nanoseconds::max ();
+        auto const DEADLINE = IS_TIMED ? clock::now () + budget.max_time : clock::time_point::max ();
+
+        task_node * recycled_first { nullptr };
+        task_node * recycled_last { nullptr };
+        std::size_t executed { 0 };
 
-            locked_queue.value ().resize (0);
+        dispatch_frame frame { this, nullptr };
+        auto const FRAME_GUARD = enter_dispatch_frame (frame);
+
+        auto const GUARD = scope_exit ([&] {
+            recycle (recycled_first, recycled_last);
+        });
+
+        while (executed < budget.max_tasks && (!IS_TIMED || clock::now () < DEADLINE)) {
+            auto * node = pop_ready_task (should_refill);
+
+            if (!node) {
+                break;
+            }
+
+            task_proxy task { std::move (node->task) };
+
+            node->next = recycled_first;
+            recycled_first = node;
+
+            if (!recycled_last) {
+                recycled_last = node;
+            }
+
+            ++executed;
+            task.invoke ();
+        }
+
+        return executed;
+    }
+
+    bool sync_dispatcher::try_dispatch_one() {
+        auto * node = pop_ready_task (true);
+
+        if (!node) {
+            return false;
         }
 
-        for (auto & task : locked_exec.value ()) {
-            task.invoke();
+        task_proxy task { std::move (node->task) };
+        recycle (node, node);
+
+        dispatch_frame frame { this, nullptr };
+        auto const FRAME_GUARD = enter_dispatch_frame (frame);
+
+        task.invoke ();
+        return true;
+    }
+
+    bool sync_dispatcher::can_help_dispatch () const noexcept {
+        for (auto const * frame = this_dispatch_frame; frame; frame = frame->outer) {
+            if (frame->owner == this) {
+                return true;
+            }
         }
+
+        return false;
     }
 
     void sync_dispatcher::enqueue_task(task_proxy &&proxy) {
-        auto locked_tasks = _queued_tasks.unique ();
-        locked_tasks.value ().emplace_back (std::forward < task_proxy > (proxy));
+        instrument (proxy);
+
+        _pending.fetch_add (1, std::memory_order_relaxed);
+        atomic_details::atomic_push (_queued_tasks, node_cache.acquire (std::forward < task_proxy > (proxy), &_free_nodes));
     }
 
-    async_dispatcher::async_dispatcher(std::size_t thread_count) {
-        for (std::size_t i = 0; i < thread_count; ++i) {
-            _worker_threads.emplace_back([this] {
-                for (;;) {
-                    task_proxy task{};
+    void sync_dispatcher::enqueue_tasks(task_proxy * tasks, std::size_t count) {
+        if (count == 0) {
+            return;
+        }
 
-                    {
-                        auto locked_tasks = this->_tasks.unique ();
+        // chain the batch most recent first and hook it at once
+        task_node * first { nullptr };
+        task_node * last { nullptr };
 
-                        this->_exec_condition.wait(
-                                locked_tasks.lock (),
-                                [&] { return !locked_tasks.value().empty() || !this->_is_running; });
+        for (std::size_t i = 0; i < count; ++i) {
+            instrument (tasks [i]);
 
-                        if (locked_tasks.value().empty() && !this->_is_running) {
-                            return;
-                        }
+            auto * node = node_cache.acquire (std::move (tasks [i]), &_free_nodes);
 
-                        task = std::move(locked_tasks.value ().front());
-                        locked_tasks.value ().pop();
-                    }
+            node->next = first;
+            first = node;
+
+            if (!last) {
+                last = node;
+            }
+        }
+
+        _pending.fetch_add (count, std::memory_order_relaxed);
+        atomic_details::atomic_insert_at_head (_queued_tasks, first, last);
+    }
+
+    task_node * sync_dispatcher::pop_ready_task(bool should_refill) {
+        std::unique_lock const LOCK (_ready_lock);
+
+        if (!_ready_head && should_refill) {
+            refill_ready_tasks ();
+        }
 
-                    task.invoke();
+        auto * node = _ready_head;
+
+        if (node) {
+            _pending.fetch_sub (1, std::memory_order_relaxed);
+            _ready_head = node->next;
+
+            if (!_ready_head) {
+                _ready_tail = nullptr;
+            }
+        }
+
+        return node;
+    }
+
+    void sync_dispatcher::refill_ready_tasks() {
+        append_in_order (atomic_details::atomic_detach (_queued_tasks), _ready_head, _ready_tail);
+    }
+
+    void sync_dispatcher::recycle(task_node * first, task_node * last) {
+        if (first) {
+            atomic_details::atomic_insert_at_head (_free_nodes, first, last);
+        }
+    }
+
+    struct async_dispatcher::worker {
+    public:
+        worker (async_dispatcher & owner_ref, std::size_t index_v) :
+            owner { owner_ref },
+            INDEX { index_v },
+            steal_seed { index_v * 0x9E3779B97F4A7C15ULL + 1 }
+        {}
+
+        ~worker () {
+            // release tasks left behind by an early shutdown
+            while (auto node = deque.pop ()) {
+                delete *node;
+            }
+
+            delete lifo_slot.exchange (nullptr, std::memory_order_acquire);
+        }
+
+        /// next pseudo random victim to steal from (xorshift)
+        std::size_t next_victim (std::size_t worker_count) {
+            steal_seed ^= steal_seed << 13U;
+            steal_seed ^= steal_seed >> 7U;
+            steal_seed ^= steal_seed << 17U;
+            return static_cast < std::size_t > (steal_seed % worker_count);
+        }
+
+        /// adapt the spin limit to the outcome of the last spin
+        void spin_feedback (bool found_task) noexcept {
+            spin_limit = found_task ?
+                std::min (spin_limit * 2, max_spin_limit) :
+                std::max (spin_limit / 2, min_spin_limit);
+        }
+
+        static constexpr std::size_t min_spin_limit { 16 };
+        static constexpr std::size_t max_spin_limit { 1024 };
+
+        async_dispatcher &  owner;
+        std::size_t const   INDEX;
+        uint64_t            steal_seed;
+        std::size_t         spin_limit { min_spin_limit };
+        std::size_t         local_tick { 0 };
+        std::size_t         lifo_streak { 0 };
+
+        core_id_t           core { UNDEFINED_CORE_ID };
+        numa_node_t         node { 0 };
+
+        /// running a thread, guarded by the resize lock
+        bool                active { false };
+
+        /// steal victims, workers of the same node first
+        std::vector < std::size_t >
+                            near_victims,
+                            far_victims;
+
+        work_stealing_deque < task_node * >
+                            deque;
+
+        /// last task posted by this worker, run next. Other workers only take it when out of work
+        std::atomic < task_node * >
+                            lifo_slot { nullptr };
+    };
+
+    thread_local async_dispatcher::worker * async_dispatcher::_this_worker { nullptr };
+
+    async_dispatcher::async_dispatcher(std::size_t thread_count, async_dispatch_mode mode) :
+        async_dispatcher (async_dispatcher_options { thread_count, mode })
+    {}
+
+    async_dispatcher::async_dispatcher(async_dispatcher_options const & options) :
+        _mode { options.mode },
+        _use_lifo_slot { options.use_lifo_slot },
+        _is_elastic { options.elastic },
+        _min_workers { std::min (std::max < std::size_t > (options.min_thread_count, 1), options.thread_count) },
+        _spawn_threshold { options.spawn_threshold },
+        _idle_timeout { options.idle_timeout },
+        _queue_capacity { options.queue_capacity },
+        _overflow { options.overflow }
+    {
+        if (options.enable_metrics) {
+            enable_metrics ();
+        }
+
+        if (_queue_capacity != 0) {
+            for (auto & lane : _tasks.unique ().value ()) {
+                lane.reserve (_queue_capacity);
+            }
+        }
+
+        for (std::size_t i = 0; i < options.thread_count; ++i) {
+            _workers.emplace_back (std::make_unique < worker > (*this, i));
+        }
+
+        if (options.pin_threads) {
+            auto const PLACEMENT = worker_placement (options);
+
+            for (std::size_t i = 0; i < PLACEMENT.size () && i < _workers.size (); ++i) {
+                _workers [i]->core = PLACEMENT [i].first;
+                _workers [i]->node = PLACEMENT [i].second;
+            }
+        }
+
+        for (auto & self : _workers) {
+            for (auto & other : _workers) {
+                if (other == self) {
+                    continue;
                 }
-            });
+
+                (other->node == self->node ? self->near_victims : self->far_victims).push_back (other->INDEX);
+            }
+        }
+
+        // an elastic pool starts small, every worker slot exists up front so stealing never races a resize
+        _worker_threads.resize (_workers.size ());
+
+        auto const INITIAL_COUNT = _is_elastic ? _min_workers : _workers.size ();
+
+        for (std::size_t i = 0; i < INITIAL_COUNT; ++i) {
+            start_worker (*_workers [i]);
         }
     }
 
@@ -66,22 +592,111 @@ namespace las {
     }
 
     void async_dispatcher::enqueue_task(task_proxy &&proxy) {
+        enqueue_priority_task (std::forward < task_proxy > (proxy), task_priority::normal);
+    }
+
+    void async_dispatcher::enqueue_tasks(task_proxy * tasks, std::size_t count) {
         if (!this->_is_running) {
             LAS_DEBUG_BREAK(); // Enqueue tasks after shutdown not supported. Call ignored!
             return;
         }
 
-        {
-            auto locked_tasks = _tasks.unique ();
-            locked_tasks.value ().push (std::forward < task_proxy >(proxy));
+        for (std::size_t i = 0; i < count; ++i) {
+            instrument (tasks [i]);
+        }
+
+        // tasks enqueued from one of our own workers stay in its local deque
+        if (auto * self = this_worker (); self && _mode == async_dispatch_mode::work_stealing) {
+            for (std::size_t i = 0; i < count; ++i) {
+                self->deque.push (node_cache.acquire (std::move (tasks [i])));
+            }
+        } else {
+            std::size_t pushed { 0 };
+
+            {
+                auto locked_tasks = _tasks.unique ();
+
+                if (_overflow == queue_overflow::reject && !has_room (count)) {
+                    throw std::system_error (std::make_error_code (std::errc::resource_unavailable_try_again), "async_dispatcher queue full");
+                }
+
+                while (pushed < count && try_push_lane_task (locked_tasks.value (), tasks [pushed], task_priority::normal)) {
+                    ++pushed;
+                }
+            }
+
+            // tasks that did not fit go through the overflow policy
+            for (; pushed < count; ++pushed) {
+                push_lane_task (std::move (tasks [pushed]), task_priority::normal);
+            }
         }
 
-        _exec_condition.notify_one();
+        // wake at most one sleeping worker per task
+        _parking.notify (count);
+
+        if (_is_elastic) {
+            check_saturation ();
+        }
+    }
+
+    void async_dispatcher::enqueue_priority_task(task_proxy &&proxy, task_priority priority) {
+        if (!this->_is_running) {
+            LAS_DEBUG_BREAK(); // Enqueue tasks after shutdown not supported. Call ignored!
+            return;
+        }
+
+        instrument (proxy);
+
+        auto * self = this_worker ();
+        bool const IS_LOCAL = self && priority == task_priority::normal;
+
+        // the worker runs its last posted task next, the task it displaces takes the regular path
+        if (IS_LOCAL && _use_lifo_slot && _queue_capacity != 0 && _mode != async_dispatch_mode::work_stealing) {
+            // a full queue applies the overflow policy to this task, never to the already accepted slot task
+            if (try_push_lifo_task (_tasks.unique ().value (), *self, proxy)) {
+                _parking.notify ();
+
+                if (_is_elastic) {
+                    check_saturation ();
+                }
+
+                return;
+            }
+        } else if (IS_LOCAL && _use_lifo_slot) {
+            auto * displaced = self->lifo_slot.exchange (node_cache.acquire (std::forward < task_proxy > (proxy)), std::memory_order_acq_rel);
+
+            if (!displaced) {
+                // the posting task may block on this one, a sleeping worker must be able to take it
+                _parking.notify ();
+                return;
+            }
+
+            proxy = std::move (displaced->task);
+            node_cache.release (displaced);
+        }
+
+        // normal tasks enqueued from one of our own workers stay in its local deque
+        if (IS_LOCAL && _mode == async_dispatch_mode::work_stealing) {
+            self->deque.push (node_cache.acquire (std::forward < task_proxy > (proxy)));
+        } else {
+            push_lane_task (std::forward < task_proxy > (proxy), priority);
+        }
+
+        // busy workers will find the task on their own, only sleeping workers cost a system call
+        _parking.notify ();
+
+        if (_is_elastic) {
+            check_saturation ();
+        }
     }
 
     void async_dispatcher::join() {
         _is_running = false;
-        _exec_condition.notify_all();
+        _parking.notify_all ();
+        _lane_space.notify_all ();
+
+        // workers only try the resize lock, holding it while joining is safe
+        std::unique_lock const LOCK (_resize_lock);
 
         for (auto & worker: _worker_threads) {
             if (worker.joinable()) {
@@ -90,4 +705,589 @@ namespace las {
         }
     }
 
-}
\ No newline at end of file
+    std::size_t async_dispatcher::concurrency () const noexcept {
+        return _workers.size ();
+    }
+
+    void async_dispatcher::collect_metrics (dispatcher_metrics_snapshot & snapshot) const {
+        snapshot.worker_count = worker_count ();
+    }
+
+    bool async_dispatcher::try_dispatch_one () {
+        task_proxy task {};
+
+        if (!try_acquire_task (this_worker (), task)) {
+            return false;
+        }
+
+        task.invoke ();
+        return true;
+    }
+
+    async_dispatcher::worker * async_dispatcher::this_worker () const noexcept {
+        return (_this_worker && &_this_worker->owner == this) ? _this_worker : nullptr;
+    }
+
+    void async_dispatcher::worker_loop (worker & self) {
+        _this_worker = &self;
+
+        for (;;) {
+            task_proxy task {};
+
+            if (try_acquire_task (&self, task) || spin_for_task (self, task)) {
+                task.invoke ();
+
+                // tasks may have been queued faster than sleeping workers woke up
+                if (_is_elastic) {
+                    check_saturation ();
+                }
+
+                continue;
+            }
+
+            // an idle worker means the pool keeps up with the load
+            if (_is_elastic && _saturated_since.load (std::memory_order_relaxed) != 0) {
+                _saturated_since.store (0, std::memory_order_relaxed);
+            }
+
+            // no work found anywhere, prepare to sleep
+            auto const KEY = _parking.prepare_wait ();
+
+            if (has_pending_tasks ()) {
+                _parking.cancel_wait ();
+                continue;
+            }
+
+            if (!_is_running) {
+                _parking.cancel_wait ();
+                break;
+            }
+
+            if (!_is_elastic) {
+                _parking.commit_wait (KEY);
+            } else if (!_parking.commit_wait_for (KEY, _idle_timeout) && try_retire (self)) {
+                break;
+            }
+        }
+
+        _this_worker = nullptr;
+    }
+
+    bool async_dispatcher::spin_for_task (worker & self, task_proxy & task) {
+        for (std::size_t i = 0; i < self.spin_limit && _is_running; ++i) {
+            _mm_pause ();
+
+            if (try_acquire_task (&self, task)) {
+                self.spin_feedback (true);
+                return true;
+            }
+        }
+
+        self.spin_feedback (false);
+        return false;
+    }
+
+    bool async_dispatcher::try_acquire_task (worker * self, task_proxy & task) {
+        if (self && _use_lifo_slot && try_take_lifo_task (*self, task)) {
+            return true;
+        }
+
+        bool const IS_STEALING = (_mode == async_dispatch_mode::work_stealing);
+
+        if (IS_STEALING) {
+            // high priority tasks and periodically the shared lanes go ahead of local work
+            bool const IS_AGING = self && (++self->local_tick % background_aging_interval) == 0;
+
+            if ((IS_AGING || _high_tasks.load (std::memory_order_relaxed) > 0) && try_acquire_lane_task (false, task)) {
+                return true;
+            }
+
+            // local tasks, most recent first for cache locality
+            if (self) {
+                if (auto node = self->deque.pop ()) {
+                    task = std::move ((*node)->task);
+                    node_cache.release (*node);
+                    return true;
+                }
+            }
+        }
+
+        // tasks enqueued from outside the pool. When stealing, a busy queue is
+        // skipped in favour of the other workers' deques
+        if (try_acquire_lane_task (!IS_STEALING, task)) {
+            return true;
+        }
+
+        if (IS_STEALING && try_steal_task (self, task)) {
+            return true;
+        }
+
+        // slot tasks are taken last, their worker is about to run them
+        return _use_lifo_slot && try_steal_lifo_task (self, task);
+    }
+
+    bool async_dispatcher::try_acquire_lane_task (bool should_block, task_proxy & task) {
+        auto locked_tasks = _tasks.unique (std::defer_lock);
+
+        if (should_block) {
+            locked_tasks.lock ().lock ();
+        } else if (!locked_tasks.lock ().try_lock ()) {
+            return false;
+        }
+
+        return pop_lane_task (locked_tasks.value (), task);
+    }
+
+    bool async_dispatcher::pop_lane_task (task_lanes & lanes, task_proxy & task) {
+        // queue lock held, pick the first lane to serve, lower lanes are periodically served first
+        auto const TICK = ++_lane_tick;
+        auto preferred = task_priority::high;
+
+        if (TICK % background_aging_interval == 0) {
+            preferred = task_priority::background;
+        } else if (TICK % normal_aging_interval == 0) {
+            preferred = task_priority::normal;
+        }
+
+        auto const take = [&](task_priority priority) {
+            auto & lane = lanes [lane_index (priority)];
+
+            if (lane.empty ()) {
+                return false;
+            }
+
+            task = std::move (lane.front ());
+            lane.pop_front ();
+
+            _lane_size.fetch_sub (1, std::memory_order_relaxed);
+
+            if (priority == task_priority::high) {
+                _high_tasks.fetch_sub (1, std::memory_order_relaxed);
+            }
+
+            // producers blocked on a full queue
+            if (_queue_capacity != 0) {
+                _lane_space.notify ();
+            }
+
+            return true;
+        };
+
+        return take (preferred) ||
+               take (task_priority::high) ||
+               take (task_priority::normal) ||
+               take (task_priority::background);
+    }
+
+    bool async_dispatcher::try_steal_task (worker * self, task_proxy & task) {
+        // steal from other workers, oldest tasks first
+        auto const STEAL_FROM = [this, &task](std::vector < std::size_t > const & victims, std::size_t first_victim) {
+            for (std::size_t i = 0; i < victims.size (); ++i) {
+                if (auto node = _workers [victims [(first_victim + i) % victims.size ()]]->deque.steal ()) {
+                    task = std::move ((*node)->task);
+                    node_cache.release (*node);
+                    return true;
+                }
+            }
+
+            return false;
+        };
+
+        if (!self) {
+            // outside threads have no locality, every worker is a victim
+            for (auto & victim : _workers) {
+                if (auto node = victim->deque.steal ()) {
+                    task = std::move ((*node)->task);
+                    node_cache.release (*node);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // same node workers first, tasks stay close to their memory
+        return
+            (!self->near_victims.empty () && STEAL_FROM (self->near_victims, self->next_victim (self->near_victims.size ()))) ||
+            (!self->far_victims.empty () && STEAL_FROM (self->far_victims, self->next_victim (self->far_victims.size ())));
+    }
+
+    bool async_dispatcher::try_steal_lifo_task (worker * self, task_proxy & task) {
+        for (auto & victim : _workers) {
+            if (victim.get () == self || !victim->lifo_slot.load (std::memory_order_relaxed)) {
+                continue;
+            }
+
+            if (auto * node = victim->lifo_slot.exchange (nullptr, std::memory_order_acq_rel)) {
+                task = std::move (node->task);
+                node_cache.release (node);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool async_dispatcher::try_take_lifo_task (worker & self, task_proxy & task) {
+        auto * node = self.lifo_slot.load (std::memory_order_relaxed) ?
+            self.lifo_slot.exchange (nullptr, std::memory_order_acq_rel) :
+            nullptr;
+
+        if (!node) {
+            self.lifo_streak = 0;
+            return false;
+        }
+
+        task = std::move (node->task);
+        node_cache.release (node);
+
+        if (self.lifo_streak < max_lifo_streak && _high_tasks.load (std::memory_order_relaxed) == 0) {
+            ++self.lifo_streak;
+            return true;
+        }
+
+        // a chain of local tasks would starve the shared queue, the slot task waits its turn there
+        self.lifo_streak = 0;
+
+        // may briefly exceed a bounded queue's capacity, a worker never waits for room
+        _tasks.unique ().value () [lane_index (task_priority::normal)].push_back (std::move (task));
+        _lane_size.fetch_add (1, std::memory_order_relaxed);
+        _parking.notify ();
+
+        return false;
+    }
+
+    bool async_dispatcher::has_pending_tasks () {
+        {
+            auto locked_tasks = _tasks.unique ();
+            auto const & lanes = locked_tasks.value ();
+
+            if (std::any_of (lanes.begin (), lanes.end (), [](auto const & lane) { return !lane.empty (); })) {
+                return true;
+            }
+        }
+
+        return std::any_of (_workers.begin (), _workers.end (), [this](auto const & worker_ptr) {
+            return !worker_ptr->deque.empty () || (_use_lifo_slot && worker_ptr->lifo_slot.load (std::memory_order_relaxed));
+        });
+    }
+
+    void async_dispatcher::start_worker (worker & self) {
+        auto & thread = _worker_threads [self.INDEX];
+
+        // a retired worker's thread has left, or is leaving, its loop
+        if (thread.joinable ()) {
+            thread.join ();
+        }
+
+        self.active = true;
+        _active_workers.fetch_add (1, std::memory_order_relaxed);
+
+        thread = std::thread ([this, &self] {
+            if (self.core != UNDEFINED_CORE_ID) {
+                this_thread_affinity_set (self.core);
+            }
+
+            this->worker_loop (self);
+        });
+    }
+
+    void async_dispatcher::check_saturation () {
+        // sleeping workers will take the load, or the pool is already at its maximum
+        if (_parking.waiters () != 0 || _active_workers.load (std::memory_order_relaxed) >= _workers.size ()) {
+            return;
+        }
+
+        // busy workers with nothing waiting behind them, such as long running tasks, need no help
+        bool const HAS_QUEUED_TASKS =
+            _lane_size.load (std::memory_order_relaxed) != 0 ||
+            std::any_of (_workers.begin (), _workers.end (), [](auto const & worker_ptr) { return !worker_ptr->deque.empty (); });
+
+        if (!HAS_QUEUED_TASKS) {
+            if (_saturated_since.load (std::memory_order_relaxed) != 0) {
+                _saturated_since.store (0, std::memory_order_relaxed);
+            }
+
+            return;
+        }
+
+        auto const NOW = std::chrono::duration_cast < std::chrono::nanoseconds > (
+            std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+
+        auto since = _saturated_since.load (std::memory_order_relaxed);
+
+        if (since == 0) {
+            _saturated_since.compare_exchange_strong (since, NOW, std::memory_order_relaxed);
+            return;
+        }
+
+        if (NOW - since < _spawn_threshold.count ()) {
+            return;
+        }
+
+        std::unique_lock const LOCK (_resize_lock, std::try_to_lock);
+
+        if (!LOCK.owns_lock () || !_is_running) {
+            return;
+        }
+
+        auto const IT = std::find_if (_workers.begin (), _workers.end (), [](auto const & worker_ptr) {
+            return !worker_ptr->active;
+        });
+
+        if (IT == _workers.end ()) {
+            return;
+        }
+
+        start_worker (**IT);
+
+        // give the new worker a full threshold to take on the load
+        _saturated_since.store (NOW, std::memory_order_relaxed);
+
+        if (auto * metrics = metrics_recorder ()) {
+            metrics->on_resize (true);
+        }
+    }
+
+    bool async_dispatcher::try_retire (worker & self) {
+        std::unique_lock const LOCK (_resize_lock, std::try_to_lock);
+
+        if (!LOCK.owns_lock () || !_is_running || _active_workers.load (std::memory_order_relaxed) <= _min_workers) {
+            return false;
+        }
+
+        self.active = false;
+        _active_workers.fetch_sub (1, std::memory_order_relaxed);
+
+        if (auto * metrics = metrics_recorder ()) {
+            metrics->on_resize (false);
+        }
+
+        return true;
+    }
+
+    bool async_dispatcher::try_enqueue_task (task_proxy && proxy, task_priority priority) {
+        auto * self = this_worker ();
+        bool const IS_LOCAL = self && priority == task_priority::normal;
+
+        // unbounded queues and worker deques always have room
+        if (_queue_capacity == 0 || (IS_LOCAL && _mode == async_dispatch_mode::work_stealing)) {
+            enqueue_priority_task (std::forward < task_proxy > (proxy), priority);
+            return true;
+        }
+
+        if (!this->_is_running) {
+            LAS_DEBUG_BREAK(); // Enqueue tasks after shutdown not supported. Call ignored!
+            return false;
+        }
+
+        {
+            auto locked_tasks = _tasks.unique ();
+
+            if (IS_LOCAL && _use_lifo_slot) {
+                instrument (proxy);
+
+                if (!try_push_lifo_task (locked_tasks.value (), *self, proxy)) {
+                    return false;
+                }
+            } else {
+                if (!has_room (1)) {
+                    return false;
+                }
+
+                instrument (proxy);
+                try_push_lane_task (locked_tasks.value (), proxy, priority);
+            }
+        }
+
+        _parking.notify ();
+
+        if (_is_elastic) {
+            check_saturation ();
+        }
+
+        return true;
+    }
+
+    bool async_dispatcher::try_push_lifo_task (task_lanes & lanes, worker & self, task_proxy & task) {
+        // queue lock held, only this worker fills its slot, a displaced task is sure to fit once checked
+        if (self.lifo_slot.load (std::memory_order_acquire) && !has_room (1)) {
+            return false;
+        }
+
+        if (auto * displaced = self.lifo_slot.exchange (node_cache.acquire (std::move (task)), std::memory_order_acq_rel)) {
+            try_push_lane_task (lanes, displaced->task, task_priority::normal);
+            node_cache.release (displaced);
+        }
+
+        return true;
+    }
+
+    bool async_dispatcher::has_room (std::size_t count) const noexcept {
+        return _queue_capacity == 0 || _lane_size.load (std::memory_order_relaxed) + count <= _queue_capacity;
+    }
+
+    bool async_dispatcher::try_push_lane_task (task_lanes & lanes, task_proxy & task, task_priority priority) {
+        // queue lock held
+        if (!has_room (1)) {
+            return false;
+        }
+
+        lanes [lane_index (priority)].push_back (std::move (task));
+        _lane_size.fetch_add (1, std::memory_order_relaxed);
+
+        if (priority == task_priority::high) {
+            _high_tasks.fetch_add (1, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+    void async_dispatcher::push_lane_task (task_proxy && task, task_priority priority) {
+        for (;;) {
+            if (try_push_lane_task (_tasks.unique ().value (), task, priority)) {
+                return;
+            }
+
+            // a worker waiting for room could wait on itself
+            if (_overflow == queue_overflow::run_inline || (_overflow == queue_overflow::block && this_worker ())) {
+                task.invoke ();
+                return;
+            }
+
+            if (_overflow == queue_overflow::reject) {
+                throw std::system_error (std::make_error_code (std::errc::resource_unavailable_try_again), "async_dispatcher queue full");
+            }
+
+            auto const KEY = _lane_space.prepare_wait ();
+
+            if (has_room (1)) {
+                _lane_space.cancel_wait ();
+                continue;
+            }
+
+            if (!_is_running) {
+                _lane_space.cancel_wait ();
+                LAS_DEBUG_BREAK(); // Dispatcher stopped while waiting for room. Task dropped!
+                return;
+            }
+
+            _lane_space.commit_wait (KEY);
+        }
+    }
+
+    thread_local strand * strand::_this_strand { nullptr };
+
+    strand::strand(dispatcher & target) noexcept :
+        _target { target }
+    {}
+
+    strand::~strand() {
+        if (_is_scheduled.load (std::memory_order_acquire)) {
+            LAS_DEBUG_BREAK(); // Strand destroyed with a scheduled drain, pending tasks are dropped!
+        }
+
+        for (auto * chain : { _queued_tasks.load (), _ready_head }) {
+            while (chain) {
+                delete std::exchange (chain, chain->next);
+            }
+        }
+    }
+
+    bool strand::running_in_this_thread() const noexcept {
+        return _this_strand == this;
+    }
+
+    void strand::enqueue_task(task_proxy &&proxy) {
+        instrument (proxy);
+
+        auto * node = node_cache.acquire (std::forward < task_proxy > (proxy));
+        push_nodes (node, node);
+    }
+
+    void strand::enqueue_tasks(task_proxy * tasks, std::size_t count) {
+        if (count == 0) {
+            return;
+        }
+
+        // chain the batch most recent first and hook it at once
+        task_node * first { nullptr };
+        task_node * last { nullptr };
+
+        for (std::size_t i = 0; i < count; ++i) {
+            instrument (tasks [i]);
+
+            auto * node = node_cache.acquire (std::move (tasks [i]));
+
+            node->next = first;
+            first = node;
+
+            if (!last) {
+                last = node;
+            }
+        }
+
+        push_nodes (first, last);
+    }
+
+    void strand::push_nodes(task_node * first, task_node * last) {
+        atomic_details::atomic_insert_at_head (_queued_tasks, first, last);
+
+        // pairs with the fence in drain, either the drain sees the tasks or this sees the flag cleared
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+
+        if (!_is_scheduled.load (std::memory_order_relaxed) && !_is_scheduled.exchange (true, std::memory_order_acq_rel)) {
+            _target.post ([this] { drain (); });
+        }
+    }
+
+    void strand::drain() {
+        auto * const PREVIOUS = std::exchange (_this_strand, this);
+
+        // also runs when a task throws, the remaining tasks stay queued in order
+        auto const GUARD = scope_exit ([this, PREVIOUS] {
+            _this_strand = PREVIOUS;
+
+            if (!_ready_head) {
+                // release, the next drain may start on another thread
+                _is_scheduled.store (false, std::memory_order_release);
+                std::atomic_thread_fence (std::memory_order_seq_cst);
+
+                if (!_queued_tasks.load (std::memory_order_relaxed) || _is_scheduled.exchange (true, std::memory_order_acq_rel)) {
+                    return;
+                }
+            }
+
+            // more work, other tasks of the target get a turn before the next batch
+            _target.post ([this] { drain (); });
+        });
+
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            if (!_ready_head) {
+                refill_ready_tasks ();
+            }
+
+            auto * node = _ready_head;
+
+            if (!node) {
+                break;
+            }
+
+            _ready_head = node->next;
+
+            if (!_ready_head) {
+                _ready_tail = nullptr;
+            }
+
+            task_proxy task { std::move (node->task) };
+            node_cache.release (node);
+
+            task.invoke ();
+        }
+    }
+
+    void strand::refill_ready_tasks() {
+        append_in_order (atomic_details::atomic_detach (_queued_tasks), _ready_head, _ready_tail);
+    }
+
+}
@@ -0,0 +1,144 @@
+#include "las/dispatcher_metrics.hpp"
+#include "las/spin_mutex.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+namespace las {
+
+    namespace {
+
+        /// unique metrics ids, addresses could be reused by a later instance
+        std::atomic_uint64_t next_metrics_id { 1 };
+
+        /// maximum number of metrics instances cached per thread
+        constexpr std::size_t thread_cache_capacity { 16 };
+
+    }
+
+    struct dispatcher_metrics::thread_counters {
+    public:
+        explicit thread_counters (std::thread::id owner_v) :
+            OWNER { owner_v }
+        {}
+
+        std::thread::id const       OWNER;
+
+        // only contended while a snapshot is taken
+        mutable spin_mutex          lock;
+
+        uint64_t                    enqueued { 0 };
+        uint64_t                    executed { 0 };
+        histogram                   wait_time;
+        histogram                   execution_time;
+
+        clock_type::time_point      first_execution {};
+        std::chrono::nanoseconds    busy { 0 };
+    };
+
+    dispatcher_metrics::dispatcher_metrics () :
+        ID { next_metrics_id.fetch_add (1, std::memory_order_relaxed) }
+    {}
+
+    dispatcher_metrics::~dispatcher_metrics () = default;
+
+    void dispatcher_metrics::on_enqueue (std::size_t count) {
+        auto & counters = this_thread_counters ();
+
+        {
+            std::unique_lock const LOCK (counters.lock);
+            counters.enqueued += count;
+        }
+
+        auto const DEPTH = _queue_depth.fetch_add (count, std::memory_order_relaxed) + count;
+        auto peak = _peak_queue_depth.load (std::memory_order_relaxed);
+
+        while (DEPTH > peak && !_peak_queue_depth.compare_exchange_weak (peak, DEPTH, std::memory_order_relaxed)) {}
+    }
+
+    void dispatcher_metrics::on_dequeue () noexcept {
+        _queue_depth.fetch_sub (1, std::memory_order_relaxed);
+    }
+
+    void dispatcher_metrics::on_execute (std::chrono::nanoseconds wait, std::chrono::nanoseconds execution) {
+        auto & counters = this_thread_counters ();
+        std::unique_lock const LOCK (counters.lock);
+
+        if (counters.executed++ == 0) {
+            counters.first_execution = clock_type::now () - execution;
+        }
+
+        counters.wait_time.record (wait);
+        counters.execution_time.record (execution);
+        counters.busy += execution;
+    }
+
+    void dispatcher_metrics::on_resize (bool is_growing) noexcept {
+        (is_growing ? _spawned_workers : _retired_workers).fetch_add (1, std::memory_order_relaxed);
+    }
+
+    dispatcher_metrics_snapshot dispatcher_metrics::snapshot () const {
+        dispatcher_metrics_snapshot result;
+
+        result.queue_depth = _queue_depth.load (std::memory_order_relaxed);
+        result.peak_queue_depth = _peak_queue_depth.load (std::memory_order_relaxed);
+        result.spawned_workers = _spawned_workers.load (std::memory_order_relaxed);
+        result.retired_workers = _retired_workers.load (std::memory_order_relaxed);
+
+        auto const NOW = clock_type::now ();
+        std::unique_lock const REGISTRY_LOCK (_registry_lock);
+
+        for (auto const & counters : _registry) {
+            std::unique_lock const LOCK (counters->lock);
+
+            result.enqueued += counters->enqueued;
+            result.executed += counters->executed;
+            result.wait_time.merge (counters->wait_time);
+            result.execution_time.merge (counters->execution_time);
+
+            if (counters->executed > 0) {
+                auto const LIFETIME = std::chrono::duration_cast < std::chrono::nanoseconds > (NOW - counters->first_execution);
+                result.workers.push_back ({ counters->busy, std::max (LIFETIME - counters->busy, std::chrono::nanoseconds::zero ()) });
+            }
+        }
+
+        return result;
+    }
+
+    dispatcher_metrics::thread_counters & dispatcher_metrics::this_thread_counters () {
+        thread_local std::vector < std::pair < uint64_t, thread_counters * > > cache;
+
+        for (auto const & [id, counters] : cache) {
+            if (id == ID) {
+                return *counters;
+            }
+        }
+
+        thread_counters * counters { nullptr };
+
+        {
+            auto const THIS_THREAD = std::this_thread::get_id ();
+            std::unique_lock const LOCK (_registry_lock);
+
+            // the thread may have been evicted from the cache
+            auto const IT = std::find_if (_registry.begin (), _registry.end (), [&THIS_THREAD](auto const & item) {
+                return item->OWNER == THIS_THREAD;
+            });
+
+            counters = IT != _registry.end () ?
+                IT->get () :
+                _registry.emplace_back (std::make_unique < thread_counters > (THIS_THREAD)).get ();
+        }
+
+        // entries of destroyed instances are never matched again, drop them all once in a while
+        if (cache.size () == thread_cache_capacity) {
+            cache.clear ();
+        }
+
+        cache.emplace_back (ID, counters);
+
+        return *counters;
+    }
+
+}
@@ -0,0 +1,116 @@
+#include "las/histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if __has_include (<bit>)
+#   include <bit>
+#endif
+
+namespace las {
+
+    namespace {
+
+        /// number of leading zero bits, 64 for zero
+        inline uint64_t leading_zeros (uint64_t value) noexcept {
+#if defined (__cpp_lib_bitops)
+            return static_cast < uint64_t > (std::countl_zero (value));
+#else
+            return value == 0 ? 64 : static_cast < uint64_t > (__builtin_clzll (value));
+#endif
+        }
+
+    }
+
+    void histogram::record (value_type value, uint64_t count) noexcept {
+        if (count == 0) {
+            return;
+        }
+
+        _buckets [bucket_index (value)] += count;
+        _count += count;
+        _sum += value * count;
+        _min = std::min (_min, value);
+        _max = std::max (_max, value);
+    }
+
+    void histogram::merge (histogram const & other) noexcept {
+        if (other._count == 0) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            _buckets [i] += other._buckets [i];
+        }
+
+        _count += other._count;
+        _sum += other._sum;
+        _min = std::min (_min, other._min);
+        _max = std::max (_max, other._max);
+    }
+
+    void histogram::reset () noexcept {
+        *this = histogram {};
+    }
+
+    double histogram::mean () const noexcept {
+        return _count ? static_cast < double > (_sum) / static_cast < double > (_count) : 0.0;
+    }
+
+    histogram::value_type histogram::percentile (double fraction) const noexcept {
+        if (_count == 0) {
+            return 0;
+        }
+
+        fraction = std::clamp (fraction, 0.0, 1.0);
+
+        // rank of the requested value, one based
+        auto const RANK = std::max < uint64_t > (1, static_cast < uint64_t > (std::ceil (fraction * static_cast < double > (_count))));
+        uint64_t seen { 0 };
+
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            seen += _buckets [i];
+
+            if (seen >= RANK) {
+                // middle of the bucket, kept within the recorded range
+                auto const LOWER = bucket_lower_bound (i);
+                auto const VALUE = LOWER + (bucket_upper_bound (i) - LOWER) / 2;
+
+                return std::clamp (VALUE, min (), _max);
+            }
+        }
+
+        return _max;
+    }
+
+    std::size_t histogram::bucket_index (value_type value) noexcept {
+        if (value < sub_bucket_count) {
+            return static_cast < std::size_t > (value);
+        }
+
+        auto const MSB = static_cast < std::size_t > (63 - leading_zeros (value));
+        auto const SHIFT = MSB - sub_bucket_bits;
+
+        return (SHIFT + 1) * sub_bucket_count + static_cast < std::size_t > ((value >> SHIFT) & (sub_bucket_count - 1));
+    }
+
+    histogram::value_type histogram::bucket_lower_bound (std::size_t index) noexcept {
+        if (index < sub_bucket_count) {
+            return index;
+        }
+
+        auto const SHIFT = index / sub_bucket_count - 1;
+        auto const SUB = index % sub_bucket_count;
+
+        return static_cast < value_type > (sub_bucket_count + SUB) << SHIFT;
+    }
+
+    histogram::value_type histogram::bucket_upper_bound (std::size_t index) noexcept {
+        if (index + 1 >= bucket_count) {
+            return std::numeric_limits < value_type >::max ();
+        }
+
+        return bucket_lower_bound (index + 1) - 1;
+    }
+
+}
@@ -1,7 +1,351 @@
 #include "las/job.hpp"
+#include "las/scope_guards.hpp"
+
+#include <exception>
+#include <mutex>
+#include <system_error>
+
+#if defined (LAS_OS_GNU_LINUX)
+#	include <sched.h>
+#endif
 
 namespace las {
 
+	namespace {
+		/// apply the options set from within the job thread
+		void apply_thread_options (job_options const & options) {
+			if (options.core != UNDEFINED_CORE_ID) {
+				this_thread_affinity_set (options.core);
+			}
+
+#if defined (LAS_OS_GNU_LINUX)
+			if (!options.name.empty ()) {
+				// including the terminator, linux thread names are limited to 16 characters
+				pthread_setname_np (pthread_self (), options.name.substr (0, 15).c_str ());
+			}
+#endif
+		}
+
+#if defined (LAS_OS_GNU_LINUX)
+		struct thread_start {
+			job_options						options;
+			std::unique_ptr < details::job_body >	body;
+		};
+
+		void * thread_entry (void * arg) {
+			std::unique_ptr < thread_start > const START { static_cast < thread_start * > (arg) };
+
+			apply_thread_options (START->options);
+			START->body->run ();
+
+			return nullptr;
+		}
+
+		void check_result (int result, char const * what) {
+			if (result != 0) {
+				throw std::system_error (result, std::generic_category (), what);
+			}
+		}
+
+		int native_policy (job_sched_policy policy) noexcept {
+			switch (policy) {
+				case job_sched_policy::fifo:
+					return SCHED_FIFO;
+				case job_sched_policy::round_robin:
+					return SCHED_RR;
+				case job_sched_policy::batch:
+					return SCHED_BATCH;
+				case job_sched_policy::idle:
+					return SCHED_IDLE;
+				default:
+					return SCHED_OTHER;
+			}
+		}
+#endif
+	}
+
+	namespace details {
+
+#if defined (LAS_OS_GNU_LINUX)
+		job_thread::job_thread (job_options const & options, std::unique_ptr < job_body > body) {
+			pthread_attr_t attributes;
+			check_result (pthread_attr_init (&attributes), "job thread attributes");
+
+			auto const DESTROY_ATTRIBUTES = las::scope_exit ([&attributes]() { pthread_attr_destroy (&attributes); });
+
+			if (options.stack_size != 0) {
+				check_result (pthread_attr_setstacksize (&attributes, options.stack_size), "job thread stack size");
+			}
+
+			// set at creation, so an unsupported or unprivileged policy fails here and not in the running thread
+			if (options.policy != job_sched_policy::inherit) {
+				sched_param param {};
+				param.sched_priority = options.priority;
+
+				check_result (pthread_attr_setinheritsched (&attributes, PTHREAD_EXPLICIT_SCHED), "job thread scheduling");
+				check_result (pthread_attr_setschedpolicy (&attributes, native_policy (options.policy)), "job thread scheduling policy");
+				check_result (pthread_attr_setschedparam (&attributes, &param), "job thread scheduling priority");
+			}
+
+			auto start = std::make_unique < thread_start > (thread_start { options, std::move (body) });
+
+			check_result (pthread_create (&_handle, &attributes, &thread_entry, start.get ()), "job thread creation");
+
+			// owned by the thread from here on
+			static_cast < void > (start.release ());
+			_is_joinable = true;
+		}
+
+		job_thread::job_thread (job_thread && other) noexcept {
+			this->swap (other);
+		}
+
+		job_thread & job_thread::operator = (job_thread && other) noexcept {
+			if (joinable ()) {
+				std::terminate ();
+			}
+
+			this->swap (other);
+			return *this;
+		}
+
+		job_thread::~job_thread () {
+			if (joinable ()) {
+				std::terminate ();
+			}
+		}
+
+		bool job_thread::joinable () const noexcept {
+			return _is_joinable;
+		}
+
+		void job_thread::join () {
+			if (!_is_joinable) {
+				throw std::system_error (std::make_error_code (std::errc::invalid_argument), "job thread not joinable");
+			}
+
+			check_result (pthread_join (_handle, nullptr), "job thread join");
+			_is_joinable = false;
+		}
+
+		void job_thread::swap (job_thread & other) noexcept {
+			std::swap (_handle, other._handle);
+			std::swap (_is_joinable, other._is_joinable);
+		}
+#else
+		job_thread::job_thread (job_options const & options, std::unique_ptr < job_body > body) :
+			_thread {
+				[](job_options options, std::unique_ptr < job_body > body) {
+					apply_thread_options (options);
+					body->run ();
+				},
+				options,
+				std::move (body)
+			}
+		{}
+
+		job_thread::job_thread (job_thread && other) noexcept = default;
+
+		job_thread & job_thread::operator = (job_thread && other) noexcept = default;
+
+		job_thread::~job_thread () = default;
+
+		bool job_thread::joinable () const noexcept {
+			return _thread.joinable ();
+		}
+
+		void job_thread::join () {
+			_thread.join ();
+		}
+
+		void job_thread::swap (job_thread & other) noexcept {
+			std::swap (_thread, other._thread);
+		}
+#endif
+
+	}
+
+	bool job_state::request_stop () {
+		if (_stop_request.atomic.exchange (1, std::memory_order_acq_rel) != 0) {
+			return false;
+		}
+
+		// wake interval waits first, callbacks take care of jobs blocked elsewhere
+		futex_wake_all (&_stop_request.integer);
+
+		std::unique_lock lock (_callback_lock);
+		_stopping_thread = std::this_thread::get_id ();
+
+		while (_callbacks) {
+			auto * callback = _callbacks;
+
+			_callbacks = callback->_next;
+
+			if (_callbacks) {
+				_callbacks->_prev = nullptr;
+			}
+
+			callback->_next = nullptr;
+			callback->_is_registered = false;
+
+			// invoke unlocked, the callback may unregister other callbacks
+			_running_callback = callback;
+			lock.unlock ();
+
+			callback->_callback ();
+
+			lock.lock ();
+			_running_callback = nullptr;
+		}
+
+		return true;
+	}
+
+	bool job_state::wait_until (clock_type::time_point time_point) noexcept {
+		for (;;) {
+			if (stop_requested ()) {
+				return false;
+			}
+
+			auto const REMAINING = time_point - clock_type::now ();
+
+			if (REMAINING <= clock_type::duration::zero ()) {
+				return true;
+			}
+
+			// rounded up, waking early would only spin
+			futex_wait (&_stop_request.integer, 0, std::chrono::ceil < std::chrono::milliseconds > (REMAINING));
+		}
+	}
+
+	job_state::clock_type::time_point job_state::begin_wait (clock_type::time_point now) noexcept {
+		auto const WAKE = deadline;
+		bool const IS_OVERRUN = interval.count () != 0 && now >= WAKE;
+
+		{
+			std::unique_lock const LOCK (_statistics_lock);
+
+			++_statistics.iterations;
+			_statistics.overruns += IS_OVERRUN ? 1 : 0;
+			_statistics.execution_time.record (now - iteration_start);
+		}
+
+		_wait_start = now;
+
+		if (interval.count () == 0) {
+			return now;
+		}
+
+		if (!IS_OVERRUN) {
+			deadline += interval;
+			return WAKE;
+		}
+
+		// overrun, skip to the first deadline ahead
+		auto const MISSED = (now - deadline) / interval;
+		deadline += interval * (MISSED + 1);
+
+		return now;
+	}
+
+	void job_state::end_wait (clock_type::time_point now) noexcept {
+		{
+			std::unique_lock const LOCK (_statistics_lock);
+			_statistics.sleep_time += now - _wait_start;
+		}
+
+		iteration_start = now;
+	}
+
+	job_statistics job_state::statistics () const {
+		std::unique_lock const LOCK (_statistics_lock);
+		return _statistics;
+	}
+
+	job_token::job_token () :
+		_standalone { std::make_shared < job_state > () },
+		_state { _standalone.get () }
+	{}
+
+	void job_token::interval_reset (std::chrono::milliseconds interval) {
+		auto & current = *_state;
+		auto const NOW = job_state::clock_type::now ();
+
+		current.interval = interval;
+		current.deadline = NOW + interval;
+		current.iteration_start = NOW;
+	}
+
+	void job_token::interval_reset () {
+		interval_reset (_state->interval);
+	}
+
+	void job_token::interval_wait () {
+		auto & current = *_state;
+
+		auto const NOW = job_state::clock_type::now ();
+		auto const WAKE = current.begin_wait (NOW);
+
+		if (WAKE > NOW) {
+			current.wait_until (WAKE);
+		} else {
+			std::this_thread::yield();
+		}
+
+		current.end_wait (job_state::clock_type::now ());
+	}
+
+	void job_token::stop () {
+		_state->request_stop ();
+	}
+
+	void job_stop_callback::attach () {
+		{
+			std::unique_lock const LOCK (_state->_callback_lock);
+
+			if (!_state->stop_requested ()) {
+				_next = _state->_callbacks;
+
+				if (_next) {
+					_next->_prev = this;
+				}
+
+				_state->_callbacks = this;
+				_is_registered = true;
+				return;
+			}
+		}
+
+		// already stopped
+		_callback ();
+	}
+
+	job_stop_callback::~job_stop_callback () {
+		for (;;) {
+			{
+				std::unique_lock const LOCK (_state->_callback_lock);
+
+				if (_is_registered) {
+					(_prev ? _prev->_next : _state->_callbacks) = _next;
+
+					if (_next) {
+						_next->_prev = _prev;
+					}
+
+					_is_registered = false;
+					return;
+				}
+
+				// not invoked or invoked by the destroying thread, no need to wait
+				if (_state->_running_callback != this || _state->_stopping_thread == std::this_thread::get_id ()) {
+					return;
+				}
+			}
+
+			std::this_thread::yield ();
+		}
+	}
+
 	job::job () = default;
 
 	job::job (job && other) noexcept {
@@ -21,7 +365,17 @@ namespace las {
 	}
 
 	void job::stop () {
-		_token.stop();
+		if (_state) {
+			_state->request_stop ();
+		}
+	}
+
+	job_token job::token () const {
+		return _state ? job_token { _state.get () } : job_token {};
+	}
+
+	job_statistics job::statistics () const {
+		return _state ? _state->statistics () : job_statistics {};
 	}
 
 	bool job::joinable () const noexcept {
@@ -33,10 +387,10 @@ namespace las {
 	}
 
 	void job::swap (job & other) {
-		std::swap (_thread, other._thread);
-		std::swap (_token, other._token);
+		_thread.swap (other._thread);
+		std::swap (_state, other._state);
 	}
 
 	thread_local job_token job::this_token {};
 
-}
\ No newline at end of file
+}
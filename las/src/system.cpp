@@ -2,6 +2,7 @@
 
 #include <las/string.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <functional>
@@ -22,7 +23,7 @@ namespace las {
                 string::cat (
                     "/sys/devices/system/cpu/cpu",
                     std::to_string (i),
-                    "/topology/thread_siblings"));
+                    "/topology/thread_siblings_list"));
 
             // read and parse thread sibling information
             auto const opt_content = file_content (cpu_path);
@@ -31,15 +32,14 @@ namespace las {
                 throw std::runtime_error ("Failed to read cpu information");
             }
 
-            auto const opt_siblings = string::as_number < uint32_t > (
-                *opt_content,
-                string::number_format::hex);
+            auto const opt_siblings = cpu_list_parse (*opt_content);
 
-            if (!opt_siblings) {
+            if (!opt_siblings || opt_siblings->empty ()) {
                 throw std::runtime_error ("Failed to read cpu information");
             }
 
-            auto core_id = ctz (*opt_siblings);
+            // the lowest sibling identifies the physical core
+            auto core_id = opt_siblings->front ();
 
             // if distinct push
             if (std::find (cores.begin(), cores.end(), core_id) == cores.end()) {
@@ -52,6 +52,50 @@ namespace las {
         return cores;
     }
 
+    std::vector < std::vector < core_id_t > > numa_nodes () {
+        using namespace std::filesystem;
+
+        // node ids may be sparse, offline or cpu-less nodes leave gaps
+        auto const opt_online = file_content (path ("/sys/devices/system/node/online"));
+
+        if (!opt_online) {
+            return {};
+        }
+
+        auto const opt_node_ids = cpu_list_parse (*opt_online);
+
+        if (!opt_node_ids || opt_node_ids->empty ()) {
+            return {};
+        }
+
+        // indexed by node id, ids without a node have no cores
+        std::vector < std::vector < core_id_t > > nodes (static_cast < std::size_t > (opt_node_ids->back ()) + 1);
+
+        for (auto const NODE_ID : *opt_node_ids) {
+            auto const node_path = path (
+                string::cat (
+                    "/sys/devices/system/node/node",
+                    std::to_string (NODE_ID),
+                    "/cpulist"));
+
+            auto const opt_content = file_content (node_path);
+
+            if (!opt_content) {
+                continue;
+            }
+
+            auto opt_cores = cpu_list_parse (*opt_content);
+
+            if (!opt_cores) {
+                return {};
+            }
+
+            nodes [NODE_ID] = std::move (*opt_cores);
+        }
+
+        return nodes;
+    }
+
 #endif
 
 #if defined (LAS_OS_WINDOWS)
@@ -104,8 +148,66 @@ namespace las {
 
         return cores;
     }
+
+    std::vector < std::vector < core_id_t > > numa_nodes () {
+        std::vector < std::vector < core_id_t > > nodes;
+        ULONG highest_node = 0;
+
+        if (!GetNumaHighestNodeNumber (&highest_node)) {
+            return {};
+        }
+
+        for (ULONG node = 0; node <= highest_node; ++node) {
+            ULONGLONG mask = 0;
+            std::vector < core_id_t > cores;
+
+            if (GetNumaNodeProcessorMask (static_cast < UCHAR > (node), &mask)) {
+                for (core_id_t core = 0; core < 64; ++core) {
+                    if (mask & (ULONGLONG (1) << core)) {
+                        cores.push_back (core);
+                    }
+                }
+            }
+
+            nodes.emplace_back (std::move (cores));
+        }
+
+        return nodes;
+    }
 #endif
 
+    std::optional < std::vector < core_id_t > > cpu_list_parse (std::string_view list) {
+        std::vector < core_id_t > cores;
+
+        for (auto const & range : string::split (string::trim (list), ",")) {
+            auto const RANGE = string::split (string::trim (range), "-");
+
+            auto const IS_NUMBER = [](std::string_view value) {
+                return !value.empty () && std::all_of (value.begin (), value.end (), [](char ch) { return ch >= '0' && ch <= '9'; });
+            };
+
+            if (RANGE.empty () || RANGE.size () > 2 || !std::all_of (RANGE.begin (), RANGE.end (), IS_NUMBER)) {
+                return std::nullopt;
+            }
+
+            auto const opt_first = string::as_number < core_id_t > (RANGE.front (), string::number_format::decimal);
+            auto const opt_last = string::as_number < core_id_t > (RANGE.back (), string::number_format::decimal);
+
+            if (!opt_first || !opt_last || *opt_last < *opt_first) {
+                return std::nullopt;
+            }
+
+            for (auto core = *opt_first; core <= *opt_last; ++core) {
+                cores.push_back (core);
+            }
+        }
+
+        std::sort (cores.begin (), cores.end ());
+        cores.erase (std::unique (cores.begin (), cores.end ()), cores.end ());
+
+        return cores;
+    }
+
     std::optional < std::string > file_content (std::filesystem::path const & file) {
         using namespace std::filesystem;
 
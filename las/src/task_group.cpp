@@ -0,0 +1,83 @@
+#include "las/task_group.hpp"
+#include "las/system.hpp"
+
+#include <mutex>
+
+namespace las {
+
+    task_group::task_group (dispatcher & target) :
+        _target { target }
+    {}
+
+    task_group::~task_group () {
+        try {
+            wait ();
+        } catch (...) {
+            // exceptions not collected by wait before destruction are dropped
+        }
+    }
+
+    void task_group::wait () {
+        for (;;) {
+            auto const PENDING = _pending.atomic.load (std::memory_order_acquire);
+
+            if (PENDING == 0) {
+                break;
+            }
+
+            // help the dispatcher, this may execute tasks of other groups
+            if (_target.can_help_dispatch () && _target.try_dispatch_one ()) {
+                continue;
+            }
+
+            futex_wait (&_pending.integer, PENDING);
+        }
+
+        std::exception_ptr error;
+
+        {
+            std::unique_lock const LOCK (_error_lock);
+            std::swap (error, _error);
+        }
+
+        _cancelled.store (false, std::memory_order_relaxed);
+
+        if (error) {
+            std::rethrow_exception (error);
+        }
+    }
+
+    void task_group::cancel () noexcept {
+        _cancelled.store (true, std::memory_order_relaxed);
+    }
+
+    bool task_group::is_cancelled () const noexcept {
+        return _cancelled.load (std::memory_order_relaxed);
+    }
+
+    std::size_t task_group::pending () const noexcept {
+        return static_cast < std::size_t > (_pending.atomic.load (std::memory_order_relaxed));
+    }
+
+    void task_group::capture_exception (std::exception_ptr error) noexcept {
+        {
+            std::unique_lock const LOCK (_error_lock);
+
+            if (!_error) {
+                _error = std::move (error);
+            }
+        }
+
+        // a failing task cancels the rest of the group
+        cancel ();
+    }
+
+    void task_group::complete_one () noexcept {
+        if (_pending.atomic.fetch_sub (1, std::memory_order_acq_rel) == 1) {
+            // the group may already be destroyed by a waiter that saw the counter reach zero, waking an address
+            // nobody waits on is harmless
+            futex_wake_all (&_pending.integer);
+        }
+    }
+
+}
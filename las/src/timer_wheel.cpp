@@ -0,0 +1,336 @@
+#include "las/timer_wheel.hpp"
+#include "las/debug.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#if __has_include (<bit>)
+#   include <bit>
+#endif
+
+namespace las {
+
+    namespace {
+
+        constexpr uint64_t slot_bits { 6 };
+        constexpr uint64_t slot_mask { timer_wheel::slot_count - 1 };
+
+        static_assert ((uint64_t { 1 } << slot_bits) == timer_wheel::slot_count, "slot_count must match slot_bits");
+
+        /// number of ticks covered by the whole wheel
+        constexpr uint64_t wheel_span { uint64_t { 1 } << (slot_bits * timer_wheel::level_count) };
+
+        /// number of trailing zero bits, 64 for zero
+        inline uint64_t trailing_zeros (uint64_t value) noexcept {
+#if defined (__cpp_lib_bitops)
+            return static_cast < uint64_t > (std::countr_zero (value));
+#else
+            return value == 0 ? 64 : static_cast < uint64_t > (__builtin_ctzll (value));
+#endif
+        }
+
+    }
+
+    timer_wheel::timer_wheel (duration resolution) :
+        RESOLUTION { std::max (resolution, duration { 1 }) },
+        START { clock_type::now () }
+    {
+        _slots.fill (npos);
+
+        _thread = std::thread ([this] {
+            this->timer_loop ();
+        });
+    }
+
+    timer_wheel::~timer_wheel () {
+        stop ();
+    }
+
+    bool timer_wheel::cancel (timer_id id) {
+        std::unique_lock const LOCK (_mutex);
+
+        if (id.index >= _entries.size ()) {
+            return false;
+        }
+
+        auto & entry = _entries [id.index];
+
+        if (entry.generation != id.generation || entry.slot == npos) {
+            return false;
+        }
+
+        unlink (id.index);
+        release (id.index);
+
+        return true;
+    }
+
+    void timer_wheel::stop () {
+        {
+            std::unique_lock const LOCK (_mutex);
+            _is_running = false;
+        }
+
+        _wake_condition.notify_all ();
+
+        if (_thread.joinable ()) {
+            _thread.join ();
+        }
+    }
+
+    std::size_t timer_wheel::size () const {
+        std::unique_lock const LOCK (_mutex);
+        return _active_count;
+    }
+
+    timer_id timer_wheel::schedule (dispatcher & target, duration delay, duration period, dispatcher::task_proxy && task) {
+        timer_id id {};
+        bool should_wake { false };
+
+        {
+            std::unique_lock const LOCK (_mutex);
+
+            if (!_is_running) {
+                LAS_DEBUG_BREAK(); // Schedule timers after stop not supported. Call ignored!
+                return id;
+            }
+
+            uint32_t index { _free_head };
+
+            if (index != npos) {
+                _free_head = _entries [index].next;
+            } else {
+                index = static_cast < uint32_t > (_entries.size ());
+                _entries.emplace_back ();
+            }
+
+            auto & entry = _entries [index];
+
+            if (period > duration::zero ()) {
+                entry.repeat_task = std::make_shared < dispatcher::task_proxy > (std::move (task));
+                entry.period = std::max < uint64_t > (to_ticks (period), 1);
+            } else {
+                entry.task = std::move (task);
+                entry.period = 0;
+            }
+
+            entry.target = &target;
+            entry.next = npos;
+            entry.expiry = std::max (elapsed_ticks (clock_type::now ()) + to_ticks (delay), _now + 1);
+
+            link (index);
+            ++_active_count;
+
+            // only wake the timer thread if it sleeps past the new expiry
+            should_wake = entry.expiry < _wake_tick;
+            id = { index, entry.generation };
+        }
+
+        if (should_wake) {
+            _wake_condition.notify_one ();
+        }
+
+        return id;
+    }
+
+    void timer_wheel::timer_loop () {
+        std::vector < fired_task > fired;
+        std::unique_lock lock (_mutex);
+
+        while (_is_running) {
+            advance_to (elapsed_ticks (clock_type::now ()));
+
+            if (!_fired.empty ()) {
+                std::swap (fired, _fired);
+
+                // post outside the lock, scheduling and cancelling stay available
+                lock.unlock ();
+
+                for (auto & item : fired) {
+                    item.target->post (std::move (item.task));
+                }
+
+                fired.clear ();
+                lock.lock ();
+
+                continue;
+            }
+
+            if (_active_count == 0) {
+                _wake_tick = std::numeric_limits < uint64_t >::max ();
+                _wake_condition.wait (lock);
+                continue;
+            }
+
+            _wake_tick = next_event_tick ();
+            _wake_condition.wait_until (lock, START + RESOLUTION * _wake_tick);
+        }
+    }
+
+    uint64_t timer_wheel::elapsed_ticks (clock_type::time_point time) const noexcept {
+        return static_cast < uint64_t > ((time - START) / RESOLUTION);
+    }
+
+    uint64_t timer_wheel::to_ticks (duration span) const noexcept {
+        if (span <= duration::zero ()) {
+            return 0;
+        }
+
+        // round up, a timer never expires early
+        return static_cast < uint64_t > ((span + RESOLUTION - duration { 1 }) / RESOLUTION);
+    }
+
+    uint64_t timer_wheel::next_event_tick () const noexcept {
+        // first occupied first level slot after now, or the next cascade
+        auto const POSITION = _now & slot_mask;
+        auto const AHEAD = _occupied [0] & ((~uint64_t { 0 } << POSITION) << 1U);
+
+        if (AHEAD != 0) {
+            return (_now & ~slot_mask) + trailing_zeros (AHEAD);
+        }
+
+        return (_now | slot_mask) + 1;
+    }
+
+    void timer_wheel::advance_to (uint64_t tick) {
+        while (_now < tick) {
+            if (_active_count == 0) {
+                _now = tick;
+                return;
+            }
+
+            // ticks without expiries or cascades are skipped
+            _now = std::min (next_event_tick (), tick);
+
+            // higher levels first, entries move down to lower levels
+            for (auto level = level_count - 1; level > 0; --level) {
+                if ((_now & ((uint64_t { 1 } << (slot_bits * level)) - 1)) == 0) {
+                    cascade (level);
+                }
+            }
+
+            expire_slot ();
+        }
+    }
+
+    void timer_wheel::cascade (std::size_t level) {
+        auto const SLOT = level * slot_count + ((_now >> (slot_bits * level)) & slot_mask);
+        auto index = std::exchange (_slots [SLOT], npos);
+
+        _occupied [level] &= ~(uint64_t { 1 } << (SLOT & slot_mask));
+
+        while (index != npos) {
+            auto & entry = _entries [index];
+            auto const NEXT = entry.next;
+
+            entry.slot = npos;
+            link (index);
+
+            index = NEXT;
+        }
+    }
+
+    void timer_wheel::expire_slot () {
+        auto const SLOT = _now & slot_mask;
+        auto index = std::exchange (_slots [SLOT], npos);
+
+        _occupied [0] &= ~(uint64_t { 1 } << SLOT);
+
+        while (index != npos) {
+            auto & entry = _entries [index];
+            auto const NEXT = entry.next;
+
+            entry.slot = npos;
+
+            if (entry.repeat_task) {
+                _fired.push_back ({ entry.target, dispatcher::task_proxy::make ([call = entry.repeat_task]() {
+                    call->invoke ();
+                }) });
+
+                // next expiry from the previous one, not from now, avoids drift
+                entry.expiry += entry.period;
+                link (index);
+            } else {
+                _fired.push_back ({ entry.target, std::move (entry.task) });
+                release (index);
+            }
+
+            index = NEXT;
+        }
+    }
+
+    void timer_wheel::link (uint32_t index) {
+        auto & entry = _entries [index];
+
+        auto const DELTA = entry.expiry - std::min (entry.expiry, _now);
+        auto placement = entry.expiry;
+        std::size_t level { 0 };
+
+        while (level < level_count && DELTA >= (uint64_t { 1 } << (slot_bits * (level + 1)))) {
+            ++level;
+        }
+
+        if (level == level_count) {
+            // beyond the wheel span, parked in the last level and cascaded again when reached
+            level = level_count - 1;
+            placement = _now + wheel_span - 1;
+        }
+
+        auto const POSITION = (placement >> (slot_bits * level)) & slot_mask;
+        auto const SLOT = static_cast < uint32_t > (level * slot_count + POSITION);
+        auto & head = _slots [SLOT];
+
+        entry.slot = SLOT;
+        entry.prev = npos;
+        entry.next = head;
+
+        if (head != npos) {
+            _entries [head].prev = index;
+        }
+
+        head = index;
+        _occupied [level] |= uint64_t { 1 } << POSITION;
+    }
+
+    void timer_wheel::unlink (uint32_t index) noexcept {
+        auto & entry = _entries [index];
+        auto const SLOT = entry.slot;
+
+        if (entry.prev != npos) {
+            _entries [entry.prev].next = entry.next;
+        } else {
+            _slots [SLOT] = entry.next;
+        }
+
+        if (entry.next != npos) {
+            _entries [entry.next].prev = entry.prev;
+        }
+
+        if (_slots [SLOT] == npos) {
+            _occupied [SLOT / slot_count] &= ~(uint64_t { 1 } << (SLOT & slot_mask));
+        }
+
+        entry.slot = npos;
+        entry.prev = npos;
+        entry.next = npos;
+    }
+
+    void timer_wheel::release (uint32_t index) noexcept {
+        auto & entry = _entries [index];
+
+        // generation zero marks an invalid id
+        if (++entry.generation == 0) {
+            entry.generation = 1;
+        }
+
+        entry.task.reset ();
+        entry.repeat_task.reset ();
+        entry.target = nullptr;
+        entry.next = _free_head;
+
+        _free_head = index;
+        --_active_count;
+    }
+
+}
@@ -1,8 +1,125 @@
 #include <catch2/catch_all.hpp>
 #include <las/dispatcher.hpp>
+#include <las/test/token.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace las::test {
 
+    SCENARIO ("Task proxy storage", "[dispatcher]") {
+        using task_proxy = dispatcher::task_proxy;
+
+        auto counters = std::make_shared<token_counters>();
+
+        STATIC_REQUIRE (sizeof (task_proxy) == 64);
+
+        GIVEN ("a task made from a small callable") {
+            int result{0};
+
+            auto callable = [item = token<int>(counters, 123), &result]() {
+                result = item.value();
+            };
+
+            STATIC_REQUIRE (task_proxy::is_inline_v<decltype(callable)>);
+
+            counters->reset();
+            auto victim = task_proxy::make(std::move(callable));
+
+            THEN ("the callable should be moved into the inline storage, never copied") {
+                REQUIRE (counters->check_copies(0));
+                REQUIRE (counters->check_moves(1));
+                REQUIRE (static_cast<bool>(victim));
+            }
+
+            WHEN ("the task is moved") {
+                counters->reset();
+                auto other_victim = std::move(victim);
+
+                THEN ("the callable should be relocated") {
+                    REQUIRE_FALSE (static_cast<bool>(victim));
+                    REQUIRE (static_cast<bool>(other_victim));
+                    REQUIRE (counters->check_copies(0));
+                    REQUIRE (counters->check_moves(1));
+                }
+
+                AND_THEN ("invoking the moved task should call the callable") {
+                    other_victim.invoke();
+                    REQUIRE (result == 123);
+                }
+            }
+
+            WHEN ("the task is reset") {
+                counters->reset();
+                victim.reset();
+
+                THEN ("the callable should be destroyed") {
+                    REQUIRE_FALSE (static_cast<bool>(victim));
+                    REQUIRE (counters->check_dtors(1));
+                }
+            }
+        }
+
+        GIVEN ("a task made from an oversized callable") {
+            std::array<char, 128> payload{};
+            payload[0] = 'x';
+            char result{0};
+
+            auto callable = [item = token<int>(counters, 123), payload, &result]() {
+                result = payload[0];
+            };
+
+            STATIC_REQUIRE_FALSE (task_proxy::is_inline_v<decltype(callable)>);
+
+            auto victim = task_proxy::make(std::move(callable));
+
+            WHEN ("the task is moved") {
+                counters->reset();
+                auto other_victim = std::move(victim);
+
+                THEN ("the callable should stay in place") {
+                    REQUIRE (counters->check_copies(0));
+                    REQUIRE (counters->check_moves(0));
+                    REQUIRE (counters->check_dtors(0));
+                }
+
+                AND_THEN ("invoking the moved task should call the callable") {
+                    other_victim.invoke();
+                    REQUIRE (result == 'x');
+                }
+            }
+        }
+
+    }
+
+    TEST_CASE ("Sync Dispatcher task life cycle", "[dispatcher]") {
+        sync_dispatcher dispatcher;
+        auto counters = std::make_shared<token_counters>();
+
+        token<int> item(counters, 1);
+        counters->reset();
+
+        dispatcher.enqueue([item = std::move(item)]() {});
+
+        // captured tokens should only be moved through the dispatcher
+        REQUIRE (counters->check_copies(0));
+
+        dispatcher.dispatch();
+
+        REQUIRE (counters->check_copies(0));
+        REQUIRE (dispatcher.is_done());
+    }
+
     TEST_CASE ("Sync Dispatcher", "[dispatcher]") {
 
         sync_dispatcher dispatcher;
@@ -66,6 +183,183 @@ namespace las::test {
 
     }
 
+    SCENARIO ("Sync Dispatcher re-entrant dispatch and drain", "[dispatcher]") {
+
+        GIVEN ("a sync dispatcher and a task chain where each task posts the next") {
+            sync_dispatcher dispatcher;
+
+            std::size_t const CHAIN_LENGTH = 10;
+            std::size_t executed{0};
+
+            std::function<void()> hop = [&]() {
+                if (++executed < CHAIN_LENGTH) {
+                    dispatcher.post(hop);
+                }
+            };
+
+            dispatcher.post(hop);
+
+            WHEN ("dispatch is called") {
+                dispatcher.dispatch();
+
+                THEN ("only the first hop should be executed") {
+                    REQUIRE(executed == 1);
+                    REQUIRE_FALSE(dispatcher.is_done());
+                }
+            }
+
+            WHEN ("drain is called without a budget") {
+                auto const COUNT = dispatcher.drain();
+
+                THEN ("the whole chain should complete in one call") {
+                    REQUIRE(COUNT == CHAIN_LENGTH);
+                    REQUIRE(executed == CHAIN_LENGTH);
+                    REQUIRE(dispatcher.is_done());
+                }
+            }
+
+            WHEN ("drain is called with a task budget") {
+                dispatch_budget budget;
+                budget.max_tasks = 4;
+
+                auto const COUNT = dispatcher.drain(budget);
+
+                THEN ("it should stop at the budget and leave the rest queued") {
+                    REQUIRE(COUNT == 4);
+                    REQUIRE(executed == 4);
+                    REQUIRE_FALSE(dispatcher.is_done());
+
+                    dispatcher.drain();
+                    REQUIRE(executed == CHAIN_LENGTH);
+                }
+            }
+
+            WHEN ("drain is called with a spent time budget") {
+                dispatch_budget budget;
+                budget.max_time = std::chrono::nanoseconds::zero();
+
+                THEN ("no task should be executed") {
+                    REQUIRE(dispatcher.drain(budget) == 0);
+                    REQUIRE(executed == 0);
+                }
+            }
+        }
+
+        GIVEN ("a sync dispatcher and a task that dispatches") {
+            sync_dispatcher dispatcher;
+            std::vector<int> order;
+
+            dispatcher.post([&]() {
+                order.push_back(1);
+                dispatcher.post([&]() { order.push_back(3); });
+
+                // nested dispatch runs the newly posted task now
+                dispatcher.dispatch();
+                order.push_back(4);
+            });
+
+            dispatcher.post([&]() { order.push_back(2); });
+
+            WHEN ("dispatch is called") {
+                dispatcher.dispatch();
+
+                THEN ("the nested dispatch should execute pending tasks in order") {
+                    REQUIRE(order == std::vector<int>{1, 2, 3, 4});
+                    REQUIRE(dispatcher.is_done());
+                }
+            }
+        }
+    }
+
+    TEST_CASE ("Sync Dispatcher time budgeted dispatch", "[dispatcher]") {
+        using namespace std::chrono_literals;
+
+        sync_dispatcher dispatcher;
+        std::vector<int> executed;
+
+        int const TASK_COUNT = 10;
+
+        for (int i = 0; i < TASK_COUNT; ++i) {
+            dispatcher.post([&executed, i]() {
+                executed.push_back(i);
+                std::this_thread::sleep_for(2ms);
+            });
+        }
+
+        REQUIRE(dispatcher.pending() == TASK_COUNT);
+
+        SECTION ("a spent budget executes nothing") {
+            auto const RESULT = dispatcher.dispatch_for(0ns);
+
+            REQUIRE(RESULT.executed == 0);
+            REQUIRE(RESULT.remaining == TASK_COUNT);
+        }
+
+        SECTION ("a short budget leaves the rest queued in order") {
+            auto const FIRST = dispatcher.dispatch_for(5ms);
+
+            REQUIRE(FIRST.executed > 0);
+            REQUIRE(FIRST.executed < TASK_COUNT);
+            REQUIRE(FIRST.executed + FIRST.remaining == TASK_COUNT);
+
+            auto const SECOND = dispatcher.dispatch_for(1s);
+
+            REQUIRE(SECOND.executed == FIRST.remaining);
+            REQUIRE(SECOND.remaining == 0);
+            REQUIRE(dispatcher.is_done());
+
+            std::vector<int> expected(TASK_COUNT);
+            std::iota(expected.begin(), expected.end(), 0);
+
+            REQUIRE(executed == expected);
+        }
+    }
+
+    TEST_CASE ("Sync Dispatcher concurrent producers", "[dispatcher]") {
+        std::size_t const PRODUCER_COUNT = 4;
+        std::size_t const TASK_COUNT = 10000;
+
+        sync_dispatcher dispatcher;
+
+        std::vector<std::vector<std::size_t>> executed(PRODUCER_COUNT);
+        std::vector<std::thread> producers;
+
+        for (std::size_t p = 0; p < PRODUCER_COUNT; ++p) {
+            producers.emplace_back([&dispatcher, &executed, p, TASK_COUNT]() {
+                for (std::size_t i = 0; i < TASK_COUNT; ++i) {
+                    dispatcher.post([&executed, p, i]() { executed[p].push_back(i); });
+                }
+            });
+        }
+
+        auto const EXECUTED_COUNT = [&executed]() {
+            std::size_t count{0};
+
+            for (auto const & sequence : executed) {
+                count += sequence.size();
+            }
+
+            return count;
+        };
+
+        // dispatch while producers are still posting, like a main loop would
+        while (EXECUTED_COUNT() < PRODUCER_COUNT * TASK_COUNT) {
+            dispatcher.dispatch();
+        }
+
+        for (auto & producer : producers) {
+            producer.join();
+        }
+
+        REQUIRE(dispatcher.is_done());
+
+        // tasks of each producer should run in post order
+        for (auto const & sequence : executed) {
+            REQUIRE(sequence.size() == TASK_COUNT);
+            REQUIRE(std::is_sorted(sequence.begin(), sequence.end()));
+        }
+    }
+
     TEST_CASE ("Async Dispatcher", "[dispatcher]") {
         using namespace std::chrono_literals;
 
@@ -121,4 +415,917 @@ namespace las::test {
 
     }
 
-}
\ No newline at end of file
+    TEST_CASE ("Async Dispatcher work stealing", "[dispatcher]") {
+        using namespace std::chrono_literals;
+
+        int const TEST_THREAD_COUNT{4};
+        async_dispatcher dispatcher{TEST_THREAD_COUNT, async_dispatch_mode::work_stealing};
+
+        REQUIRE (dispatcher.mode() == async_dispatch_mode::work_stealing);
+
+        SECTION ("Enqueue from outside the pool") {
+            std::promise<int> task_promise_value;
+            auto task_future_value = task_promise_value.get_future();
+
+            dispatcher.enqueue(
+                    [&task_promise_value](int value) {
+                        task_promise_value.set_value(value);
+                    },
+                    123);
+
+            if (task_future_value.wait_for(1s) == std::future_status::timeout) {
+                FAIL("Future timedout");
+            }
+
+            REQUIRE (task_future_value.get() == 123);
+        }
+
+        SECTION ("Tasks enqueued from workers") {
+            int const PARENT_COUNT{16};
+            int const CHILD_COUNT{256};
+
+            std::atomic_int completed{0};
+            std::promise<void> done_promise;
+            auto done_future = done_promise.get_future();
+
+            for (int i = 0; i < PARENT_COUNT; ++i) {
+                dispatcher.enqueue([&]() {
+                    // children are pushed to this worker's local deque and stolen by idle workers
+                    for (int j = 0; j < CHILD_COUNT; ++j) {
+                        dispatcher.enqueue([&]() {
+                            if (++completed == PARENT_COUNT * CHILD_COUNT) {
+                                done_promise.set_value();
+                            }
+                        });
+                    }
+                });
+            }
+
+            if (done_future.wait_for(5s) == std::future_status::timeout) {
+                FAIL("Timeout");
+            }
+
+            REQUIRE (completed == PARENT_COUNT * CHILD_COUNT);
+        }
+
+    }
+
+    TEST_CASE ("Dispatcher post and submit", "[dispatcher]") {
+        using namespace std::chrono_literals;
+
+        SECTION ("Sync dispatcher post") {
+            sync_dispatcher dispatcher;
+            int task_value{};
+
+            dispatcher.post([&task_value]() { task_value += 1; });
+            dispatcher.post([&task_value](int value) { task_value += value; }, 10);
+
+            REQUIRE (task_value == 0);
+
+            dispatcher.dispatch();
+
+            REQUIRE (task_value == 11);
+            REQUIRE (dispatcher.is_done());
+        }
+
+        SECTION ("Sync dispatcher submit") {
+            sync_dispatcher dispatcher;
+
+            auto value_future = dispatcher.submit([](int value) { return value * 2; }, 21);
+            auto error_future = dispatcher.submit([]() -> int { throw std::runtime_error("task error"); });
+
+            dispatcher.dispatch();
+
+            REQUIRE (value_future.get() == 42);
+            REQUIRE_THROWS_AS (error_future.get(), std::runtime_error);
+        }
+
+        SECTION ("Posted tasks store the callable without copies") {
+            sync_dispatcher dispatcher;
+            auto counters = std::make_shared<token_counters>();
+
+            token<int> item(counters, 1);
+            counters->reset();
+
+            dispatcher.post([item = std::move(item)]() {});
+
+            REQUIRE (counters->check_copies(0));
+            // one move into the lambda, one into the task inline storage, one into the queue
+            REQUIRE (counters->check_moves(3));
+        }
+
+        SECTION ("Async dispatcher post and submit") {
+            async_dispatcher dispatcher{2};
+
+            std::promise<int> task_promise_value;
+            auto task_future_value = task_promise_value.get_future();
+
+            dispatcher.post(
+                    [&task_promise_value](int value) {
+                        task_promise_value.set_value(value);
+                    },
+                    123);
+
+            auto submit_future = dispatcher.submit([]() { return 321; });
+
+            if (task_future_value.wait_for(1s) == std::future_status::timeout) {
+                FAIL("Future timedout");
+            }
+
+            if (submit_future.wait_for(1s) == std::future_status::timeout) {
+                FAIL("Future timedout");
+            }
+
+            REQUIRE (task_future_value.get() == 123);
+            REQUIRE (submit_future.get() == 321);
+        }
+
+    }
+
+    TEST_CASE ("Dispatcher bulk post", "[dispatcher]") {
+        using namespace std::chrono_literals;
+
+        int const TASK_COUNT{256};
+
+        SECTION ("Sync dispatcher") {
+            sync_dispatcher dispatcher;
+            std::vector<int> executed;
+
+            std::vector<std::function<void()>> batch;
+
+            for (int i = 0; i < TASK_COUNT; ++i) {
+                batch.emplace_back([&executed, i]() { executed.push_back(i); });
+            }
+
+            dispatcher.post_bulk(batch.begin(), batch.end());
+            dispatcher.dispatch();
+
+            // tasks should run in batch order
+            REQUIRE (executed.size() == TASK_COUNT);
+            REQUIRE (std::is_sorted(executed.begin(), executed.end()));
+        }
+
+        for (auto const MODE : {async_dispatch_mode::shared_queue, async_dispatch_mode::work_stealing}) {
+            DYNAMIC_SECTION ("Async dispatcher mode " << static_cast<int>(MODE)) {
+                async_dispatcher dispatcher{4, MODE};
+
+                std::atomic_int completed{0};
+                std::promise<void> done_promise;
+                auto done_future = done_promise.get_future();
+
+                auto const TASK = [&]() {
+                    if (++completed == TASK_COUNT * 2) {
+                        done_promise.set_value();
+                    }
+                };
+
+                std::vector<std::decay_t<decltype(TASK)>> batch(TASK_COUNT, TASK);
+
+                // from outside the pool
+                dispatcher.post_bulk(batch.begin(), batch.end());
+
+                // from inside the pool
+                dispatcher.post([&dispatcher, &batch]() {
+                    dispatcher.post_bulk(batch.begin(), batch.end());
+                });
+
+                if (done_future.wait_for(5s) == std::future_status::timeout) {
+                    FAIL("Timeout");
+                }
+
+                REQUIRE (completed == TASK_COUNT * 2);
+            }
+        }
+
+    }
+
+    TEST_CASE ("Async Dispatcher pinned workers", "[dispatcher]") {
+        async_dispatcher_options options;
+
+        options.thread_count = 4;
+        options.mode = async_dispatch_mode::work_stealing;
+        options.pin_threads = true;
+
+        auto const SKIP_SMT = GENERATE(true, false);
+        options.skip_smt_siblings = SKIP_SMT;
+
+        async_dispatcher dispatcher{options};
+        std::atomic_size_t completed{0};
+
+        std::size_t const TASK_COUNT = 1000;
+
+        for (std::size_t i = 0; i < TASK_COUNT; ++i) {
+            dispatcher.post([&dispatcher, &completed]() {
+                dispatcher.post([&completed]() { ++completed; });
+            });
+        }
+
+        while (completed.load() < TASK_COUNT) {
+            std::this_thread::yield();
+        }
+
+        REQUIRE(dispatcher.concurrency() == options.thread_count);
+        REQUIRE(completed == TASK_COUNT);
+    }
+
+    TEST_CASE ("Async Dispatcher priority lanes", "[dispatcher]") {
+        std::atomic_bool started{false};
+        std::atomic_bool released{false};
+        std::vector<task_priority> executed;
+
+        // a single worker, held by a gate task while the lanes are filled
+        async_dispatcher dispatcher{1};
+
+        dispatcher.post([&]() {
+            started = true;
+
+            while (!released) {
+                std::this_thread::yield();
+            }
+        });
+
+        while (!started) {
+            std::this_thread::yield();
+        }
+
+        auto const POST = [&](task_priority priority) {
+            dispatcher.post(priority, [&executed, priority]() { executed.push_back(priority); });
+        };
+
+        SECTION ("higher lanes are served first") {
+            for (auto priority : {task_priority::background, task_priority::normal, task_priority::high}) {
+                for (int i = 0; i < 3; ++i) {
+                    POST(priority);
+                }
+            }
+
+            released = true;
+            dispatcher.join();
+
+            REQUIRE(executed == std::vector<task_priority>{
+                task_priority::high, task_priority::high, task_priority::high,
+                task_priority::normal, task_priority::normal, task_priority::normal,
+                task_priority::background, task_priority::background, task_priority::background});
+        }
+
+        SECTION ("lower lanes are not starved") {
+            std::size_t const HIGH_COUNT = async_dispatcher::background_aging_interval * 2;
+
+            POST(task_priority::background);
+
+            for (std::size_t i = 0; i < HIGH_COUNT; ++i) {
+                POST(task_priority::high);
+            }
+
+            released = true;
+            dispatcher.join();
+
+            auto const BACKGROUND_AT = std::find(executed.begin(), executed.end(), task_priority::background);
+
+            REQUIRE(executed.size() == HIGH_COUNT + 1);
+            REQUIRE(static_cast<std::size_t>(BACKGROUND_AT - executed.begin()) < async_dispatcher::background_aging_interval);
+        }
+
+        SECTION ("submit with priority returns the result") {
+            auto priority = task_priority::high;
+            auto future = dispatcher.submit(priority, [](int value) { return value * 2; }, 21);
+
+            released = true;
+
+            REQUIRE(future.get() == 42);
+        }
+    }
+
+    TEST_CASE ("Async Dispatcher work stealing priority lanes", "[dispatcher]") {
+        async_dispatcher dispatcher{4, async_dispatch_mode::work_stealing};
+        std::atomic_size_t completed{0};
+
+        std::size_t const TASK_COUNT = 3000;
+
+        for (std::size_t i = 0; i < TASK_COUNT; ++i) {
+            auto const PRIORITY = static_cast<task_priority>(i % task_priority_count);
+
+            dispatcher.post(PRIORITY, [&dispatcher, &completed, PRIORITY]() {
+                // tasks posted from workers follow the same lanes
+                dispatcher.post(PRIORITY, [&completed]() { ++completed; });
+            });
+        }
+
+        while (completed.load() < TASK_COUNT) {
+            std::this_thread::yield();
+        }
+
+        REQUIRE(completed == TASK_COUNT);
+    }
+
+    TEST_CASE ("Dispatcher metrics", "[dispatcher]") {
+        std::size_t const TASK_COUNT = 100;
+
+        SECTION ("disabled by default") {
+            sync_dispatcher dispatcher;
+
+            dispatcher.post([]() {});
+            dispatcher.dispatch();
+
+            auto const METRICS = dispatcher.metrics();
+
+            REQUIRE_FALSE(dispatcher.metrics_enabled());
+            REQUIRE(METRICS.enqueued == 0);
+            REQUIRE(METRICS.executed == 0);
+            REQUIRE(METRICS.workers.empty());
+        }
+
+        SECTION ("sync dispatcher") {
+            sync_dispatcher dispatcher;
+            dispatcher.enable_metrics();
+
+            for (std::size_t i = 0; i < TASK_COUNT; ++i) {
+                dispatcher.post([]() {});
+            }
+
+            auto const QUEUED = dispatcher.metrics();
+
+            REQUIRE(dispatcher.metrics_enabled());
+            REQUIRE(QUEUED.enqueued == TASK_COUNT);
+            REQUIRE(QUEUED.executed == 0);
+            REQUIRE(QUEUED.queue_depth == TASK_COUNT);
+            REQUIRE(QUEUED.peak_queue_depth == TASK_COUNT);
+
+            dispatcher.dispatch();
+
+            auto const DONE = dispatcher.metrics();
+
+            REQUIRE(DONE.executed == TASK_COUNT);
+            REQUIRE(DONE.queue_depth == 0);
+            REQUIRE(DONE.peak_queue_depth == TASK_COUNT);
+            REQUIRE(DONE.wait_time.count() == TASK_COUNT);
+            REQUIRE(DONE.execution_time.count() == TASK_COUNT);
+            REQUIRE(DONE.workers.size() == 1);
+        }
+
+        SECTION ("async dispatcher") {
+            auto const MODE = GENERATE(async_dispatch_mode::work_stealing, async_dispatch_mode::shared_queue);
+
+            async_dispatcher_options options;
+
+            options.thread_count = 4;
+            options.mode = MODE;
+            options.enable_metrics = true;
+
+            async_dispatcher dispatcher{options};
+
+            for (std::size_t i = 0; i < TASK_COUNT; ++i) {
+                dispatcher.post([&dispatcher]() {
+                    dispatcher.post([]() { std::this_thread::sleep_for(std::chrono::microseconds{10}); });
+                });
+            }
+
+            // execution is recorded after the task returns
+            while (dispatcher.metrics().executed < TASK_COUNT * 2) {
+                std::this_thread::yield();
+            }
+
+            auto const METRICS = dispatcher.metrics();
+
+            REQUIRE(METRICS.enqueued == TASK_COUNT * 2);
+            REQUIRE(METRICS.executed == TASK_COUNT * 2);
+            REQUIRE(METRICS.queue_depth == 0);
+            REQUIRE(METRICS.peak_queue_depth >= 1);
+            REQUIRE(METRICS.execution_time.max() >= 10000);
+            REQUIRE_FALSE(METRICS.workers.empty());
+            REQUIRE(METRICS.workers.size() <= options.thread_count);
+
+            for (auto const & worker : METRICS.workers) {
+                REQUIRE(worker.busy_ratio() >= 0.0);
+                REQUIRE(worker.busy_ratio() <= 1.0);
+            }
+        }
+    }
+
+    TEST_CASE ("Async Dispatcher LIFO slot", "[dispatcher]") {
+        std::vector<int> executed;
+        std::atomic_bool done{false};
+
+        async_dispatcher_options options;
+
+        options.thread_count = 1;
+        options.use_lifo_slot = GENERATE(true, false);
+
+        async_dispatcher dispatcher{options};
+
+        auto const WAIT_DONE = [&done]() {
+            while (!done) {
+                std::this_thread::yield();
+            }
+        };
+
+        SECTION ("the last posted task runs next") {
+            std::atomic_size_t finished{0};
+
+            dispatcher.post([&]() {
+                dispatcher.post([&]() { executed.push_back(1); ++finished; });
+                dispatcher.post([&]() { executed.push_back(2); ++finished; });
+            });
+
+            while (finished.load() < 2) {
+                std::this_thread::yield();
+            }
+
+            if (options.use_lifo_slot) {
+                REQUIRE(executed == std::vector<int>{2, 1});
+            } else {
+                REQUIRE(executed == std::vector<int>{1, 2});
+            }
+        }
+
+        SECTION ("task chains do not starve queued tasks") {
+            int const CHAIN_LENGTH = 16;
+            std::atomic_bool queued{false};
+            std::function<void(int)> chain;
+
+            chain = [&](int index) {
+                executed.push_back(index);
+
+                if (index < CHAIN_LENGTH) {
+                    dispatcher.post(chain, index + 1);
+                } else {
+                    done = true;
+                }
+            };
+
+            dispatcher.post([&]() {
+                // start the chain once the outside task is queued
+                while (!queued) {
+                    std::this_thread::yield();
+                }
+
+                chain(0);
+            });
+
+            dispatcher.post([&]() { executed.push_back(-1); });
+            queued = true;
+
+            WAIT_DONE();
+
+            auto const OUTSIDE_AT = std::find(executed.begin(), executed.end(), -1);
+
+            REQUIRE(OUTSIDE_AT != executed.end());
+            REQUIRE(static_cast<std::size_t>(OUTSIDE_AT - executed.begin()) <= async_dispatcher::max_lifo_streak + 1);
+        }
+    }
+
+    TEST_CASE ("Async Dispatcher LIFO slot with a blocking parent task", "[dispatcher]") {
+        using namespace std::chrono_literals;
+
+        async_dispatcher_options options;
+
+        options.thread_count = 2;
+        options.mode = GENERATE(async_dispatch_mode::work_stealing, async_dispatch_mode::shared_queue);
+        options.use_lifo_slot = true;
+
+        async_dispatcher dispatcher{options};
+
+        // let the second worker go to sleep
+        std::this_thread::sleep_for(10ms);
+
+        auto parent = dispatcher.submit([&dispatcher]() {
+            auto child = dispatcher.submit([]() { return 42; });
+
+            // the child sits in this worker's slot, only the sleeping worker can run it
+            return child.wait_for(2s) == std::future_status::ready ? child.get() : -1;
+        });
+
+        REQUIRE(parent.get() == 42);
+    }
+
+    TEST_CASE ("Async Dispatcher elastic pool", "[dispatcher]") {
+        using namespace std::chrono_literals;
+
+        auto const MODE = GENERATE(async_dispatch_mode::work_stealing, async_dispatch_mode::shared_queue);
+
+        async_dispatcher_options options;
+
+        options.thread_count = 4;
+        options.mode = MODE;
+        options.elastic = true;
+        options.min_thread_count = 1;
+        options.spawn_threshold = 100us;
+        options.idle_timeout = 20ms;
+        options.enable_metrics = true;
+
+        async_dispatcher dispatcher{options};
+        std::atomic_size_t completed{0};
+
+        auto const RUN_LOAD = [&]() {
+            std::size_t const TASK_COUNT = 200;
+            completed = 0;
+
+            for (std::size_t i = 0; i < TASK_COUNT; ++i) {
+                dispatcher.post([&completed]() {
+                    std::this_thread::sleep_for(200us);
+                    ++completed;
+                });
+            }
+
+            while (completed.load() < TASK_COUNT) {
+                std::this_thread::yield();
+            }
+        };
+
+        auto const WAIT_FOR_WORKERS = [&](std::size_t count) {
+            auto const DEADLINE = std::chrono::steady_clock::now() + 2s;
+
+            while (dispatcher.worker_count() != count && std::chrono::steady_clock::now() < DEADLINE) {
+                std::this_thread::sleep_for(1ms);
+            }
+
+            return dispatcher.worker_count() == count;
+        };
+
+        REQUIRE(dispatcher.concurrency() == options.thread_count);
+        REQUIRE(dispatcher.worker_count() == options.min_thread_count);
+
+        SECTION ("grows under load and shrinks when idle") {
+            RUN_LOAD();
+
+            auto const LOADED = dispatcher.metrics();
+
+            REQUIRE(LOADED.spawned_workers > 0);
+            REQUIRE(LOADED.spawned_workers <= options.thread_count - options.min_thread_count + LOADED.retired_workers);
+
+            REQUIRE(WAIT_FOR_WORKERS(options.min_thread_count));
+
+            auto const IDLE = dispatcher.metrics();
+
+            REQUIRE(IDLE.worker_count == options.min_thread_count);
+            REQUIRE(IDLE.spawned_workers == IDLE.retired_workers);
+        }
+
+        SECTION ("busy workers with nothing queued do not grow the pool") {
+            std::size_t const CHAIN_LENGTH = 20;
+            std::atomic_size_t remaining{CHAIN_LENGTH};
+            std::function<void()> chain;
+
+            // each task posts the next one into the worker's LIFO slot, the worker is never idle and the queues stay empty
+            chain = [&]() {
+                std::this_thread::sleep_for(1ms);
+
+                if (--remaining > 0) {
+                    dispatcher.post(chain);
+                }
+            };
+
+            dispatcher.post(chain);
+
+            while (remaining.load() > 0) {
+                std::this_thread::yield();
+            }
+
+            REQUIRE(dispatcher.metrics().spawned_workers == 0);
+        }
+
+        SECTION ("retired workers are started again") {
+            RUN_LOAD();
+            REQUIRE(WAIT_FOR_WORKERS(options.min_thread_count));
+
+            auto const FIRST_SPAWNED = dispatcher.metrics().spawned_workers;
+
+            RUN_LOAD();
+
+            REQUIRE(dispatcher.metrics().spawned_workers > FIRST_SPAWNED);
+        }
+    }
+
+    TEST_CASE ("Async Dispatcher bounded queue", "[dispatcher]") {
+        std::size_t const CAPACITY = 4;
+
+        std::atomic_bool started{false};
+        std::atomic_bool released{false};
+        std::atomic_size_t executed{0};
+
+        async_dispatcher_options options;
+
+        options.thread_count = 1;
+        options.queue_capacity = CAPACITY;
+        options.overflow = GENERATE(queue_overflow::block, queue_overflow::reject, queue_overflow::run_inline);
+
+        async_dispatcher dispatcher{options};
+
+        REQUIRE(dispatcher.queue_capacity() == CAPACITY);
+
+        // hold the only worker and fill the queue
+        dispatcher.post([&]() {
+            started = true;
+
+            while (!released) {
+                std::this_thread::yield();
+            }
+        });
+
+        while (!started) {
+            std::this_thread::yield();
+        }
+
+        for (std::size_t i = 0; i < CAPACITY; ++i) {
+            REQUIRE(dispatcher.try_post([&]() { ++executed; }));
+        }
+
+        auto const WAIT_EXECUTED = [&](std::size_t count) {
+            while (executed.load() < count) {
+                std::this_thread::yield();
+            }
+        };
+
+        SECTION ("try_post fails fast on a full queue") {
+            REQUIRE_FALSE(dispatcher.try_post([&]() { ++executed; }));
+            REQUIRE_FALSE(dispatcher.try_post(task_priority::high, [&]() { ++executed; }));
+
+            released = true;
+            WAIT_EXECUTED(CAPACITY);
+
+            // room again once drained
+            REQUIRE(dispatcher.try_post([&]() { ++executed; }));
+            WAIT_EXECUTED(CAPACITY + 1);
+        }
+
+        SECTION ("the overflow policy handles a full queue") {
+            auto const CALLER = std::this_thread::get_id();
+
+            switch (options.overflow) {
+                case queue_overflow::reject: {
+                    std::array<std::function<void()>, 2> tasks{[&]() { ++executed; }, [&]() { ++executed; }};
+
+                    REQUIRE_THROWS_AS(dispatcher.post([&]() { ++executed; }), std::system_error);
+                    REQUIRE_THROWS_AS(dispatcher.post_bulk(tasks.begin(), tasks.end()), std::system_error);
+
+                    released = true;
+                    WAIT_EXECUTED(CAPACITY);
+
+                    // nothing of the rejected tasks was enqueued
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    REQUIRE(executed.load() == CAPACITY);
+                    break;
+                }
+                case queue_overflow::run_inline: {
+                    std::thread::id ran_on{};
+
+                    dispatcher.post([&]() { ran_on = std::this_thread::get_id(); ++executed; });
+
+                    REQUIRE(ran_on == CALLER);
+                    REQUIRE(executed.load() == 1);
+
+                    released = true;
+                    WAIT_EXECUTED(CAPACITY + 1);
+                    break;
+                }
+                case queue_overflow::block: {
+                    std::atomic_bool posted{false};
+                    std::atomic<std::thread::id> ran_on{};
+
+                    std::thread producer([&]() {
+                        dispatcher.post([&]() { ran_on = std::this_thread::get_id(); ++executed; });
+                        posted = true;
+                    });
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    REQUIRE_FALSE(posted.load());
+
+                    released = true;
+                    producer.join();
+
+                    REQUIRE(posted.load());
+
+                    WAIT_EXECUTED(CAPACITY + 1);
+                    REQUIRE(ran_on.load() != CALLER);
+                    break;
+                }
+            }
+        }
+
+        released = true;
+        WAIT_EXECUTED(CAPACITY);
+    }
+
+    TEST_CASE ("Async Dispatcher bounded queue try_post from a worker", "[dispatcher]") {
+        std::size_t const CAPACITY = 2;
+
+        async_dispatcher_options options;
+
+        options.thread_count = 1;
+        options.queue_capacity = CAPACITY;
+        options.overflow = GENERATE(queue_overflow::block, queue_overflow::reject, queue_overflow::run_inline);
+        options.use_lifo_slot = true;
+
+        async_dispatcher dispatcher{options};
+
+        std::atomic_size_t executed{0};
+
+        auto result = dispatcher.submit([&]() {
+            std::size_t accepted{0};
+
+            // the first task fills the slot, every other one displaces the slot task into the queue
+            while (dispatcher.try_post([&]() { ++executed; })) {
+                ++accepted;
+            }
+
+            return std::make_pair(accepted, executed.load());
+        });
+
+        std::pair<std::size_t, std::size_t> outcome{};
+
+        REQUIRE_NOTHROW(outcome = result.get());
+
+        // displaced slot tasks are never pushed through the overflow policy
+        REQUIRE(outcome.first == CAPACITY + 1);
+        REQUIRE(outcome.second == 0);
+
+        while (executed.load() < CAPACITY + 1) {
+            std::this_thread::yield();
+        }
+    }
+
+    TEST_CASE ("Async Dispatcher bounded queue rejecting posts from a worker", "[dispatcher]") {
+        async_dispatcher_options options;
+
+        options.thread_count = 1;
+        options.queue_capacity = 1;
+        options.overflow = queue_overflow::reject;
+        options.use_lifo_slot = true;
+
+        async_dispatcher dispatcher{options};
+
+        std::array<std::atomic_int, 3> executed{};
+
+        auto result = dispatcher.submit([&]() {
+            // the first task fills the slot, the second displaces it into the queue, the third does not fit
+            dispatcher.post([&]() { ++executed[0]; });
+            dispatcher.post([&]() { ++executed[1]; });
+            dispatcher.post([&]() { ++executed[2]; });
+        });
+
+        REQUIRE_THROWS_AS(result.get(), std::system_error);
+
+        while (executed[0].load() + executed[1].load() < 2) {
+            std::this_thread::yield();
+        }
+
+        // the rejected task is dropped, the accepted ones run
+        REQUIRE(dispatcher.submit([]() {}).wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+        REQUIRE(executed[0] == 1);
+        REQUIRE(executed[1] == 1);
+        REQUIRE(executed[2] == 0);
+    }
+
+    TEST_CASE ("Strand on a sync dispatcher", "[dispatcher][strand]") {
+        sync_dispatcher dispatcher;
+        strand serial{dispatcher};
+
+        std::vector<int> executed;
+
+        SECTION ("tasks run in order on the target") {
+            REQUIRE_FALSE(serial.running_in_this_thread());
+
+            serial.post([&]() {
+                REQUIRE(serial.running_in_this_thread());
+                executed.push_back(1);
+            });
+
+            std::array<std::function<void()>, 2> const BATCH{
+                [&]() { executed.push_back(3); },
+                [&]() { executed.push_back(4); }};
+
+            serial.post([&]() { executed.push_back(2); });
+            serial.post_bulk(BATCH.begin(), BATCH.end());
+
+            REQUIRE(dispatcher.pending() == 1);
+
+            dispatcher.drain();
+
+            REQUIRE(executed == std::vector<int>{1, 2, 3, 4});
+            REQUIRE(dispatcher.is_done());
+        }
+
+        SECTION ("large batches hand the target back between drains") {
+            for (std::size_t i = 0; i < strand::batch_size * 2; ++i) {
+                serial.post([&executed, i]() { executed.push_back(static_cast<int>(i)); });
+            }
+
+            dispatcher.dispatch();
+            REQUIRE(executed.size() == strand::batch_size);
+
+            dispatcher.dispatch();
+            REQUIRE(executed.size() == strand::batch_size * 2);
+            REQUIRE(std::is_sorted(executed.begin(), executed.end()));
+        }
+
+        SECTION ("a throwing task leaves the remaining tasks queued") {
+            serial.post([&]() { executed.push_back(1); });
+            serial.post([]() { throw std::runtime_error("strand task"); });
+            serial.post([&]() { executed.push_back(3); });
+
+            REQUIRE_THROWS_AS(dispatcher.dispatch(), std::runtime_error);
+            REQUIRE(executed == std::vector<int>{1});
+
+            dispatcher.drain();
+            REQUIRE(executed == std::vector<int>{1, 3});
+        }
+    }
+
+    TEST_CASE ("Strands on an async dispatcher", "[dispatcher][strand]") {
+        std::size_t const STRAND_COUNT = 1000;
+        std::size_t const PRODUCER_COUNT = 4;
+        std::size_t const TASKS_PER_PRODUCER = 50;
+
+        struct serial_state {
+            std::atomic_size_t active{0};
+            std::vector<std::size_t> last_sequence = std::vector<std::size_t>(PRODUCER_COUNT, 0);
+        };
+
+        async_dispatcher dispatcher{4, GENERATE(async_dispatch_mode::work_stealing, async_dispatch_mode::shared_queue)};
+
+        std::vector<std::unique_ptr<strand>> strands;
+        std::vector<serial_state> states(STRAND_COUNT);
+
+        for (std::size_t i = 0; i < STRAND_COUNT; ++i) {
+            strands.push_back(std::make_unique<strand>(dispatcher));
+        }
+
+        std::atomic_size_t overlaps{0};
+        std::atomic_size_t out_of_order{0};
+        std::atomic_size_t completed{0};
+
+        std::vector<std::thread> producers;
+
+        for (std::size_t producer = 0; producer < PRODUCER_COUNT; ++producer) {
+            producers.emplace_back([&, producer]() {
+                for (std::size_t sequence = 1; sequence <= TASKS_PER_PRODUCER; ++sequence) {
+                    for (std::size_t i = 0; i < STRAND_COUNT; ++i) {
+                        strands[i]->post([&, i, producer, sequence]() {
+                            auto & state = states[i];
+
+                            if (state.active.fetch_add(1) != 0) {
+                                ++overlaps;
+                            }
+
+                            // plain memory, only safe because the strand serializes its tasks
+                            if (state.last_sequence[producer] + 1 != sequence) {
+                                ++out_of_order;
+                            }
+
+                            state.last_sequence[producer] = sequence;
+                            state.active.fetch_sub(1);
+
+                            ++completed;
+                        });
+                    }
+                }
+            });
+        }
+
+        for (auto & producer : producers) {
+            producer.join();
+        }
+
+        while (completed.load() < STRAND_COUNT * PRODUCER_COUNT * TASKS_PER_PRODUCER) {
+            std::this_thread::yield();
+        }
+
+        REQUIRE(overlaps == 0);
+        REQUIRE(out_of_order == 0);
+
+        // strands are idle, their drains have returned or are returning
+        dispatcher.join();
+    }
+
+    TEST_CASE ("Dispatcher bulk post benchmark", "[.][benchmark][dispatcher]") {
+        std::size_t const BATCH_SIZE{256};
+
+        async_dispatcher dispatcher{std::thread::hardware_concurrency()};
+        std::atomic_size_t completed{0};
+
+        auto const TASK = [&completed]() { ++completed; };
+        std::vector<std::decay_t<decltype(TASK)>> batch(BATCH_SIZE, TASK);
+
+        auto const WAIT_COMPLETION = [&completed, BATCH_SIZE]() {
+            while (completed.load() < BATCH_SIZE) {
+                std::this_thread::yield();
+            }
+
+            completed = 0;
+        };
+
+        BENCHMARK ("post x256") {
+            for (auto const & task : batch) {
+                dispatcher.post(task);
+            }
+
+            WAIT_COMPLETION();
+        };
+
+        BENCHMARK ("post_bulk x256") {
+            dispatcher.post_bulk(batch.begin(), batch.end());
+            WAIT_COMPLETION();
+        };
+    }
+
+}
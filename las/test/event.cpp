@@ -0,0 +1,37 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/dispatcher.hpp>
+#include <las/event.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+namespace las::test {
+
+    TEST_CASE ("Event invoke on a dispatcher", "[event]") {
+        event < int > source;
+        std::atomic_int received { 0 };
+
+        auto const THROWING = source.append ([](int) { throw std::runtime_error ("observer"); });
+        auto const RECEIVING = source.append ([&received](int value) { received = value; });
+
+        SECTION ("a throwing observer does not escape into the worker thread") {
+            async_dispatcher dispatcher { 1 };
+
+            source.invoke (dispatcher, 1);
+
+            // the worker survived the exception and keeps executing tasks
+            REQUIRE_NOTHROW (dispatcher.submit ([]() {}).get ());
+            REQUIRE (received == 0);
+        }
+
+        SECTION ("a throwing observer does not escape dispatch") {
+            sync_dispatcher dispatcher;
+
+            source.invoke (dispatcher, 1);
+
+            REQUIRE_NOTHROW (dispatcher.dispatch ());
+        }
+    }
+
+}
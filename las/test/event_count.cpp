@@ -0,0 +1,129 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/event_count.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace las::test {
+
+    SCENARIO ("Event count wait and notify", "[event_count]") {
+
+        GIVEN ("an event count without waiters") {
+            event_count events;
+
+            THEN ("notify should not fail") {
+                events.notify ();
+                events.notify_all ();
+
+                REQUIRE (events.waiters () == 0);
+            }
+
+            WHEN ("a wait is prepared and cancelled") {
+                auto const KEY = events.prepare_wait ();
+                (void)KEY;
+
+                REQUIRE (events.waiters () == 1);
+
+                events.cancel_wait ();
+
+                THEN ("no waiter should remain") {
+                    REQUIRE (events.waiters () == 0);
+                }
+            }
+
+            WHEN ("a notification is issued between prepare and commit") {
+                auto const KEY = events.prepare_wait ();
+
+                events.notify ();
+
+                THEN ("commit should return immediately") {
+                    events.commit_wait (KEY);
+                    REQUIRE (events.waiters () == 0);
+                }
+            }
+
+            WHEN ("a timed wait is committed without notification") {
+                auto const KEY = events.prepare_wait ();
+                auto const START = std::chrono::steady_clock::now ();
+
+                THEN ("it should time out") {
+                    REQUIRE_FALSE (events.commit_wait_for (KEY, std::chrono::milliseconds { 10 }));
+                    REQUIRE (std::chrono::steady_clock::now () - START >= std::chrono::milliseconds { 10 });
+                    REQUIRE (events.waiters () == 0);
+                }
+            }
+
+            WHEN ("a timed wait is notified") {
+                auto const KEY = events.prepare_wait ();
+
+                events.notify ();
+
+                THEN ("it should report the notification") {
+                    REQUIRE (events.commit_wait_for (KEY, std::chrono::seconds { 1 }));
+                    REQUIRE (events.waiters () == 0);
+                }
+            }
+        }
+    }
+
+    TEST_CASE ("Event count wakes waiting threads", "[event_count]") {
+        std::size_t const   THREAD_COUNT = 4;
+        int const           ITEM_COUNT = 10000;
+
+        event_count         events;
+        std::atomic_int     items { 0 };
+        std::atomic_int     consumed { 0 };
+        std::atomic_bool    done { false };
+
+        std::vector < std::thread > consumers;
+
+        for (std::size_t i = 0; i < THREAD_COUNT; ++i) {
+            consumers.emplace_back ([&] {
+                for (;;) {
+                    auto available = items.load ();
+
+                    if (available > 0) {
+                        if (items.compare_exchange_weak (available, available - 1)) {
+                            ++consumed;
+                        }
+
+                        continue;
+                    }
+
+                    auto const KEY = events.prepare_wait ();
+
+                    if (items.load () > 0) {
+                        events.cancel_wait ();
+                        continue;
+                    }
+
+                    if (done.load ()) {
+                        events.cancel_wait ();
+                        return;
+                    }
+
+                    events.commit_wait (KEY);
+                }
+            });
+        }
+
+        for (int i = 0; i < ITEM_COUNT; ++i) {
+            ++items;
+            events.notify ();
+        }
+
+        done = true;
+        events.notify_all ();
+
+        for (auto & consumer : consumers) {
+            consumer.join ();
+        }
+
+        REQUIRE (consumed == ITEM_COUNT);
+        REQUIRE (events.waiters () == 0);
+    }
+
+}
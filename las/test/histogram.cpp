@@ -0,0 +1,113 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/histogram.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+namespace las::test {
+
+    using namespace std::chrono_literals;
+
+    SCENARIO ("Histogram recording", "[histogram]") {
+
+        GIVEN ("an empty histogram") {
+            histogram values;
+
+            THEN ("every statistic should be zero") {
+                REQUIRE (values.count () == 0);
+                REQUIRE (values.sum () == 0);
+                REQUIRE (values.min () == 0);
+                REQUIRE (values.max () == 0);
+                REQUIRE (values.mean () == 0.0);
+                REQUIRE (values.percentile (0.5) == 0);
+            }
+
+            WHEN ("small values are recorded") {
+                for (uint64_t i = 0; i < histogram::sub_bucket_count; ++i) {
+                    values.record (i);
+                }
+
+                THEN ("they should be reported exactly") {
+                    REQUIRE (values.count () == histogram::sub_bucket_count);
+                    REQUIRE (values.min () == 0);
+                    REQUIRE (values.max () == histogram::sub_bucket_count - 1);
+                    REQUIRE (values.percentile (0.0) == 0);
+                    REQUIRE (values.percentile (0.5) == histogram::sub_bucket_count / 2 - 1);
+                    REQUIRE (values.percentile (1.0) == histogram::sub_bucket_count - 1);
+                }
+            }
+
+            WHEN ("a range of durations is recorded") {
+                for (uint64_t i = 1; i <= 10000; ++i) {
+                    values.record (std::chrono::nanoseconds { i * 100 });
+                }
+
+                THEN ("percentiles should be within the bucket precision") {
+                    auto const TOLERANCE = 1.0 / static_cast < double > (histogram::sub_bucket_count);
+
+                    for (auto fraction : { 0.5, 0.9, 0.99 }) {
+                        auto const EXPECTED = fraction * 1000000.0;
+                        auto const REPORTED = static_cast < double > (values.percentile (fraction));
+
+                        REQUIRE (REPORTED >= EXPECTED * (1.0 - TOLERANCE));
+                        REQUIRE (REPORTED <= EXPECTED * (1.0 + TOLERANCE));
+                    }
+
+                    REQUIRE (values.min () == 100);
+                    REQUIRE (values.max () == 1000000);
+                    REQUIRE (values.sum () == 5000500000);
+                }
+            }
+
+            WHEN ("a negative duration is recorded") {
+                values.record (-1ns);
+
+                THEN ("it should be recorded as zero") {
+                    REQUIRE (values.count () == 1);
+                    REQUIRE (values.max () == 0);
+                }
+            }
+        }
+    }
+
+    TEST_CASE ("Histogram buckets", "[histogram]") {
+        // every value falls within the bounds of its bucket
+        for (uint64_t value : { uint64_t { 0 }, uint64_t { 7 }, uint64_t { 8 }, uint64_t { 1000 }, uint64_t { 123456789 }, UINT64_MAX }) {
+            auto const INDEX = histogram::bucket_index (value);
+
+            REQUIRE (INDEX < histogram::bucket_count);
+            REQUIRE (histogram::bucket_lower_bound (INDEX) <= value);
+            REQUIRE (histogram::bucket_upper_bound (INDEX) >= value);
+        }
+
+        // buckets are contiguous
+        for (std::size_t i = 1; i < histogram::bucket_count; ++i) {
+            REQUIRE (histogram::bucket_lower_bound (i) == histogram::bucket_upper_bound (i - 1) + 1);
+        }
+    }
+
+    TEST_CASE ("Histogram merge and reset", "[histogram]") {
+        histogram first;
+        histogram second;
+
+        first.record (10, 3);
+        second.record (1000);
+        second.record (5);
+
+        first.merge (second);
+
+        REQUIRE (first.count () == 5);
+        REQUIRE (first.sum () == 1035);
+        REQUIRE (first.min () == 5);
+        REQUIRE (first.max () == 1000);
+        REQUIRE (first.bucket (histogram::bucket_index (10)) == 3);
+
+        first.reset ();
+
+        REQUIRE (first.count () == 0);
+        REQUIRE (first.min () == 0);
+        REQUIRE (first.max () == 0);
+    }
+
+}
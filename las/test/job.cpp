@@ -0,0 +1,309 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/job.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace las::test {
+
+    using namespace std::chrono_literals;
+
+    SCENARIO ("Job stop requests", "[job]") {
+
+        GIVEN ("a running job") {
+            std::atomic_bool started { false };
+            std::atomic_bool stop_seen { false };
+
+            job worker ([&](job_token token) {
+                started = true;
+
+                while (!token.stop_requested ()) {
+                    std::this_thread::yield ();
+                }
+
+                stop_seen = job::this_token.stop_requested ();
+            });
+
+            while (!started) {
+                std::this_thread::yield ();
+            }
+
+            REQUIRE_FALSE (worker.token ().stop_requested ());
+
+            WHEN ("the job is moved and stopped") {
+                job moved { std::move (worker) };
+
+                moved.stop ();
+                moved.join ();
+
+                THEN ("the running thread should see the stop request") {
+                    REQUIRE (stop_seen);
+                    REQUIRE (moved.token ().stop_requested ());
+                    REQUIRE_FALSE (worker.joinable ());
+                }
+            }
+        }
+
+        GIVEN ("a standalone token") {
+            job_token token;
+            job_token const COPY { token };
+
+            REQUIRE_FALSE (COPY.stop_requested ());
+
+            WHEN ("it is stopped") {
+                token.stop ();
+
+                THEN ("its copies should see the stop request") {
+                    REQUIRE (token.stop_requested ());
+                    REQUIRE (COPY.stop_requested ());
+                }
+            }
+        }
+    }
+
+    SCENARIO ("Job stop callbacks", "[job]") {
+
+        GIVEN ("a job blocked outside of its token") {
+            std::atomic_bool released { false };
+            std::atomic_bool registered { false };
+
+            job worker ([&](job_token token) {
+                job_stop_callback const CALLBACK (token, [&released]() { released = true; });
+                registered = true;
+
+                while (!released) {
+                    std::this_thread::yield ();
+                }
+            });
+
+            while (!registered) {
+                std::this_thread::yield ();
+            }
+
+            WHEN ("the job is stopped") {
+                worker.stop ();
+
+                THEN ("the callback should release it") {
+                    REQUIRE (released);
+                    worker.join ();
+                }
+            }
+        }
+
+        GIVEN ("a job that is not running") {
+            job worker ([](job_token) {});
+            worker.join ();
+
+            int invoked { 0 };
+
+            WHEN ("a callback is unregistered before the stop") {
+                std::optional < job_stop_callback > callback;
+                callback.emplace (worker.token (), [&invoked]() { ++invoked; });
+                callback.reset ();
+
+                worker.stop ();
+
+                THEN ("it should not be invoked") {
+                    REQUIRE (invoked == 0);
+                }
+            }
+
+            WHEN ("callbacks are registered before the stop") {
+                job_stop_callback const FIRST (worker.token (), [&invoked]() { ++invoked; });
+                job_stop_callback const SECOND (worker.token (), [&invoked]() { ++invoked; });
+
+                worker.stop ();
+                worker.stop ();
+
+                THEN ("each should be invoked once") {
+                    REQUIRE (invoked == 2);
+                }
+            }
+
+            WHEN ("a callback is registered after the stop") {
+                worker.stop ();
+
+                job_stop_callback const CALLBACK (worker.token (), [&invoked]() { ++invoked; });
+
+                THEN ("it should be invoked immediately") {
+                    REQUIRE (invoked == 1);
+                }
+            }
+        }
+    }
+
+    SCENARIO ("Job interval waits", "[job]") {
+
+        GIVEN ("a job waiting on a long interval") {
+            std::atomic_bool waiting { false };
+
+            job worker ([&](job_token token) {
+                token.interval_reset (10min);
+
+                while (!token.stop_requested ()) {
+                    waiting = true;
+                    token.interval_wait ();
+                }
+            });
+
+            while (!waiting) {
+                std::this_thread::yield ();
+            }
+
+            WHEN ("the job is stopped") {
+                auto const START = std::chrono::steady_clock::now ();
+
+                worker.stop ();
+                worker.join ();
+
+                THEN ("it should wake up without waiting for the interval") {
+                    REQUIRE (std::chrono::steady_clock::now () - START < 5s);
+                }
+            }
+        }
+
+        GIVEN ("a fixed rate loop") {
+            std::size_t const ITERATIONS = 5;
+            auto const INTERVAL = 20ms;
+
+            WHEN ("it runs on a standalone token") {
+                job_token token;
+
+                auto const START = std::chrono::steady_clock::now ();
+                token.interval_reset (INTERVAL);
+
+                for (std::size_t i = 0; i < ITERATIONS; ++i) {
+                    token.interval_wait ();
+                }
+
+                THEN ("every interval should be waited for from its absolute deadline") {
+                    REQUIRE (std::chrono::steady_clock::now () - START >= INTERVAL * ITERATIONS);
+                }
+            }
+
+            WHEN ("an iteration overruns") {
+                job_token token;
+
+                auto const START = std::chrono::steady_clock::now ();
+                token.interval_reset (INTERVAL);
+
+                std::this_thread::sleep_for (INTERVAL * 2 + INTERVAL / 2);
+                token.interval_wait ();
+                token.interval_wait ();
+
+                THEN ("missed intervals should be skipped, not caught up") {
+                    REQUIRE (std::chrono::steady_clock::now () - START >= INTERVAL * 3);
+                }
+            }
+        }
+    }
+
+
+    SCENARIO ("Job launch options", "[job]") {
+
+        GIVEN ("a job started with launch options") {
+            job_options options;
+
+            options.core = 0;
+            options.policy = job_sched_policy::other;
+            options.stack_size = 1024 * 1024;
+            options.name = "las-job-with-a-long-name";
+
+            std::atomic_bool ran { false };
+
+#if defined (LAS_OS_GNU_LINUX)
+            std::string name;
+            std::size_t stack_size { 0 };
+            int policy { -1 };
+#endif
+
+            job worker (options, [&]() {
+#if defined (LAS_OS_GNU_LINUX)
+                char buffer [16] {};
+                pthread_getname_np (pthread_self (), buffer, sizeof (buffer));
+                name = buffer;
+
+                pthread_attr_t attributes;
+                pthread_getattr_np (pthread_self (), &attributes);
+                pthread_attr_getstacksize (&attributes, &stack_size);
+                pthread_attr_destroy (&attributes);
+
+                sched_param param {};
+                pthread_getschedparam (pthread_self (), &policy, &param);
+#endif
+                ran = true;
+            });
+
+            worker.join ();
+
+            THEN ("the options should be applied before the body runs") {
+                REQUIRE (ran);
+
+#if defined (LAS_OS_GNU_LINUX)
+                REQUIRE (name == options.name.substr (0, 15));
+                REQUIRE (stack_size >= options.stack_size);
+                REQUIRE (policy == SCHED_OTHER);
+#endif
+            }
+        }
+
+#if defined (LAS_OS_GNU_LINUX)
+        GIVEN ("launch options with an invalid priority") {
+            job_options options;
+
+            options.policy = job_sched_policy::fifo;
+            options.priority = 0;
+
+            THEN ("the job should fail to start") {
+                REQUIRE_THROWS_AS (job (options, []() {}), std::system_error);
+            }
+        }
+#endif
+    }
+
+
+    SCENARIO ("Job interval statistics", "[job]") {
+
+        GIVEN ("a fixed rate job with an overrunning iteration") {
+            std::size_t const ITERATIONS = 4;
+            auto const INTERVAL = 20ms;
+
+            job worker ([&](job_token token) {
+                token.interval_reset (INTERVAL);
+
+                for (std::size_t i = 0; i < ITERATIONS; ++i) {
+                    std::this_thread::sleep_for (i == 0 ? INTERVAL + INTERVAL / 2 : 2ms);
+                    token.interval_wait ();
+                }
+            });
+
+            worker.join ();
+
+            THEN ("every iteration should be recorded") {
+                auto const STATISTICS = worker.statistics ();
+
+                REQUIRE (STATISTICS.iterations == ITERATIONS);
+                REQUIRE (STATISTICS.overruns == 1);
+                REQUIRE (STATISTICS.execution_time.count () == ITERATIONS);
+                REQUIRE (STATISTICS.execution_time.min () >= 2000000);
+                REQUIRE (STATISTICS.execution_time.max () >= 30000000);
+                REQUIRE (STATISTICS.sleep_time > 0ns);
+                REQUIRE (STATISTICS.sleep_time < INTERVAL * ITERATIONS);
+            }
+        }
+
+        GIVEN ("a default constructed job") {
+            job worker;
+
+            THEN ("its statistics should be empty") {
+                REQUIRE (worker.statistics ().iterations == 0);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,145 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/job_host.hpp>
+
+#if defined (LAS_HAS_COROUTINES)
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace las::test {
+
+    using namespace std::chrono_literals;
+
+    namespace {
+
+        task <> count_intervals (hosted_job_token token, std::chrono::milliseconds interval, std::atomic_size_t & iterations) {
+            token.interval_reset (interval);
+
+            while (!token.stop_requested ()) {
+                ++iterations;
+                co_await token.interval_wait ();
+            }
+        }
+
+        template < typename predicate_t >
+        bool wait_for (predicate_t && predicate) {
+            auto const DEADLINE = std::chrono::steady_clock::now () + 5s;
+
+            while (!predicate ()) {
+                if (std::chrono::steady_clock::now () > DEADLINE) {
+                    return false;
+                }
+
+                std::this_thread::yield ();
+            }
+
+            return true;
+        }
+
+    }
+
+    SCENARIO ("Jobs hosted on a job host", "[job_host]") {
+
+        GIVEN ("a job host with a single thread") {
+            job_host host { 1 };
+
+            REQUIRE (host.concurrency () == 1);
+
+            WHEN ("more jobs than threads wait on intervals") {
+                std::size_t const JOB_COUNT = 32;
+
+                std::vector < std::atomic_size_t > iterations (JOB_COUNT);
+                std::vector < hosted_job > jobs;
+
+                for (auto & count : iterations) {
+                    jobs.push_back (host.start (count_intervals, 5ms, std::ref (count)));
+                }
+
+                THEN ("every job should progress") {
+                    REQUIRE (host.size () == JOB_COUNT);
+
+                    for (auto & count : iterations) {
+                        REQUIRE (wait_for ([&count]() { return count.load () >= 3; }));
+                    }
+                }
+
+                AND_WHEN ("the jobs are stopped") {
+                    auto const START = std::chrono::steady_clock::now ();
+
+                    for (auto & job : jobs) {
+                        job.stop ();
+                    }
+
+                    for (auto & job : jobs) {
+                        job.join ();
+                    }
+
+                    THEN ("they should return without waiting for their interval") {
+                        REQUIRE (std::chrono::steady_clock::now () - START < 2s);
+                        REQUIRE (host.size () == 0);
+                    }
+                }
+            }
+
+            WHEN ("a job sleeps on a long interval") {
+                std::atomic_size_t iterations { 0 };
+                auto job = host.start (count_intervals, 10min, std::ref (iterations));
+
+                REQUIRE (wait_for ([&iterations]() { return iterations.load () == 1; }));
+
+                THEN ("stopping it should wake it up") {
+                    auto const START = std::chrono::steady_clock::now ();
+
+                    job.stop ();
+                    REQUIRE (wait_for ([&job]() { return job.is_done (); }));
+
+                    REQUIRE (std::chrono::steady_clock::now () - START < 2s);
+                    REQUIRE (iterations.load () == 1);
+                    REQUIRE (job.statistics ().iterations == 1);
+
+                    job.join ();
+                }
+            }
+
+            WHEN ("a job without a token is started") {
+                std::atomic_bool ran { false };
+
+                auto job = host.start ([&ran]() -> task <> {
+                    ran = true;
+                    co_return;
+                });
+
+                job.join ();
+
+                THEN ("it should run to completion") {
+                    REQUIRE (ran);
+                    REQUIRE (job.is_done ());
+                    REQUIRE_FALSE (job.joinable ());
+                }
+            }
+        }
+
+        GIVEN ("a job host with running jobs") {
+            std::atomic_size_t iterations { 0 };
+
+            auto host = std::make_unique < job_host > (2);
+            auto job = host->start (count_intervals, 1s, std::ref (iterations));
+
+            WHEN ("the host is destroyed") {
+                host.reset ();
+
+                THEN ("its jobs should be stopped") {
+                    REQUIRE (job.is_done ());
+                    REQUIRE (job.token ().stop_requested ());
+                }
+            }
+        }
+    }
+
+}
+
+#endif
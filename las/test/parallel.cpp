@@ -0,0 +1,176 @@
+#include <catch2/catch_all.hpp>
+#include <las/parallel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace las::test {
+
+    TEST_CASE ("parallel_for", "[parallel]") {
+        std::size_t const ITEM_COUNT{100000};
+
+        async_dispatcher async_target{4, async_dispatch_mode::work_stealing};
+        sync_dispatcher sync_target;
+
+        for (dispatcher * target : {static_cast<dispatcher *>(&async_target), static_cast<dispatcher *>(&sync_target)}) {
+            DYNAMIC_SECTION ("concurrency " << target->concurrency()) {
+
+                SECTION ("every index is visited exactly once") {
+                    std::vector<std::atomic_int> visits(ITEM_COUNT);
+
+                    for (auto const GRAIN : {auto_grain, std::size_t{1}, std::size_t{1000}, ITEM_COUNT * 2}) {
+                        for (auto & visit : visits) {
+                            visit = 0;
+                        }
+
+                        parallel_for(*target, std::size_t{0}, ITEM_COUNT, GRAIN, [&visits](std::size_t begin, std::size_t end) {
+                            for (auto i = begin; i < end; ++i) {
+                                ++visits[i];
+                            }
+                        });
+
+                        REQUIRE (std::all_of(visits.begin(), visits.end(), [](auto const & visit) { return visit == 1; }));
+                    }
+                }
+
+                SECTION ("offset and empty ranges") {
+                    std::atomic_int sum{0};
+
+                    parallel_for(*target, -10, 10, 3, [&sum](int begin, int end) {
+                        for (auto i = begin; i < end; ++i) {
+                            sum += i;
+                        }
+                    });
+
+                    REQUIRE (sum == -10);
+
+                    parallel_for(*target, 10, 10, auto_grain, [](int, int) {
+                        FAIL ("empty range should not call the body");
+                    });
+                }
+
+                SECTION ("view chunks") {
+                    std::vector<int> values(ITEM_COUNT, 1);
+                    std::atomic_size_t oversized_chunks{0};
+
+                    parallel_for(*target, view{values}, 256, [&oversized_chunks](view<int> chunk) {
+                        if (chunk.size() > 256) {
+                            ++oversized_chunks;
+                        }
+
+                        for (auto & value : chunk) {
+                            value *= 2;
+                        }
+                    });
+
+                    REQUIRE (oversized_chunks == 0);
+                    REQUIRE (std::all_of(values.begin(), values.end(), [](int value) { return value == 2; }));
+                }
+
+                SECTION ("exceptions are rethrown on the calling thread") {
+                    REQUIRE_THROWS_AS (
+                            parallel_for(*target, 0, 1000, 10, [](int begin, int) {
+                                if (begin == 500) {
+                                    throw std::runtime_error("chunk error");
+                                }
+                            }),
+                            std::runtime_error);
+                }
+
+                SECTION ("parallel_reduce") {
+                    auto const SUM = parallel_reduce(
+                            *target, std::size_t{0}, ITEM_COUNT, auto_grain, std::size_t{0},
+                            [](std::size_t begin, std::size_t end) {
+                                std::size_t partial{0};
+
+                                for (auto i = begin; i < end; ++i) {
+                                    partial += i;
+                                }
+
+                                return partial;
+                            },
+                            std::plus<>{});
+
+                    REQUIRE (SUM == ITEM_COUNT * (ITEM_COUNT - 1) / 2);
+                }
+
+                SECTION ("parallel_reduce keeps chunk order") {
+                    std::string const SOURCE{"the quick brown fox jumps over the lazy dog"};
+                    std::vector<char> letters(SOURCE.begin(), SOURCE.end());
+
+                    auto const RESULT = parallel_reduce(
+                            *target, view{letters}, 3, std::string{},
+                            [](view<char> chunk) { return std::string(chunk.begin(), chunk.end()); },
+                            [](std::string lhv, std::string rhv) { return lhv + rhv; });
+
+                    REQUIRE (RESULT == SOURCE);
+                }
+            }
+        }
+
+        // tasks left behind by the loops only check their split claims
+        sync_target.dispatch();
+    }
+
+    TEST_CASE ("parallel_for nested in a dispatched task", "[parallel]") {
+        using namespace std::chrono_literals;
+
+        async_dispatcher target{2};
+
+        auto result = target.submit([&target]() {
+            return parallel_reduce(
+                    target, 0, 10000, 10, 0,
+                    [](int begin, int end) { return end - begin; },
+                    std::plus<>{});
+        });
+
+        REQUIRE (result.wait_for(5s) == std::future_status::ready);
+        REQUIRE (result.get() == 10000);
+    }
+
+    TEST_CASE ("parallel_for on a rejecting dispatcher", "[parallel]") {
+        std::size_t const ITEM_COUNT{1000};
+
+        async_dispatcher_options options;
+
+        options.thread_count = 1;
+        options.queue_capacity = 1;
+        options.overflow = queue_overflow::reject;
+
+        async_dispatcher target{options};
+
+        std::atomic_bool started{false};
+        std::atomic_bool released{false};
+
+        // hold the only worker, the queue fills after the first posted half
+        target.post([&]() {
+            started = true;
+
+            while (!released) {
+                std::this_thread::yield();
+            }
+        });
+
+        while (!started) {
+            std::this_thread::yield();
+        }
+
+        std::vector<std::atomic_int> visits(ITEM_COUNT);
+
+        REQUIRE_NOTHROW(parallel_for(target, std::size_t{0}, ITEM_COUNT, 1, [&visits](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                ++visits[i];
+            }
+        }));
+
+        released = true;
+
+        // halves that were not enqueued ran on the calling thread
+        REQUIRE(std::all_of(visits.begin(), visits.end(), [](auto const & count) { return count.load() == 1; }));
+    }
+
+}
@@ -0,0 +1,48 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/system.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace las::test {
+
+    TEST_CASE ("cpu list parse", "[system]") {
+        SECTION ("single cores and ranges") {
+            REQUIRE (cpu_list_parse ("0-3,8,10-11\n") == std::vector < core_id_t > { 0, 1, 2, 3, 8, 10, 11 });
+        }
+
+        SECTION ("overlapping and unordered entries") {
+            REQUIRE (cpu_list_parse ("4,0-2,1") == std::vector < core_id_t > { 0, 1, 2, 4 });
+        }
+
+        SECTION ("empty list") {
+            REQUIRE (cpu_list_parse ("\n") == std::vector < core_id_t > {});
+        }
+
+        SECTION ("malformed lists") {
+            REQUIRE_FALSE (cpu_list_parse ("3-1").has_value ());
+            REQUIRE_FALSE (cpu_list_parse ("0-a").has_value ());
+            REQUIRE_FALSE (cpu_list_parse ("1-2-3").has_value ());
+        }
+    }
+
+    TEST_CASE ("NUMA topology", "[system]") {
+        auto const NODES = numa_nodes ();
+
+        // every core belongs to a single node
+        std::vector < core_id_t > cores;
+
+        for (auto const & node : NODES) {
+            cores.insert (cores.end (), node.begin (), node.end ());
+        }
+
+        auto const CORE_COUNT = cores.size ();
+
+        std::sort (cores.begin (), cores.end ());
+        cores.erase (std::unique (cores.begin (), cores.end ()), cores.end ());
+
+        REQUIRE (cores.size () == CORE_COUNT);
+    }
+
+}
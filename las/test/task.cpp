@@ -0,0 +1,173 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/task.hpp>
+
+#if defined (LAS_HAS_COROUTINES)
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace las::test {
+
+    using namespace std::chrono_literals;
+
+    namespace {
+
+        task < int > add (dispatcher & owner, int lhs, int rhs) {
+            co_await owner.schedule ();
+            co_return lhs + rhs;
+        }
+
+        task < int > add_chain (dispatcher & owner) {
+            auto const FIRST = co_await add (owner, 1, 2);
+            auto const SECOND = co_await add (owner, FIRST, 3);
+
+            co_return SECOND;
+        }
+
+        task <> fail (dispatcher & owner) {
+            co_await owner.schedule ();
+            throw std::runtime_error ("task failure");
+        }
+
+        task < std::thread::id > resumed_thread (dispatcher & owner) {
+            co_await owner.schedule ();
+            co_return std::this_thread::get_id ();
+        }
+
+        task < bool > count_on_strand (strand & serial, int & counter) {
+            co_await serial.schedule ();
+
+            // not atomic, the strand runs one task at a time
+            ++counter;
+            co_return serial.running_in_this_thread ();
+        }
+
+        /// dispatch a sync dispatcher until a future is ready
+        template < typename value_t >
+        bool dispatch_until_ready (sync_dispatcher & dispatcher, std::future < value_t > & future) {
+            auto const DEADLINE = std::chrono::steady_clock::now () + 2s;
+
+            while (future.wait_for (0s) != std::future_status::ready) {
+                if (std::chrono::steady_clock::now () > DEADLINE) {
+                    return false;
+                }
+
+                dispatcher.dispatch ();
+            }
+
+            return true;
+        }
+
+    }
+
+    SCENARIO ("Coroutine tasks on a sync dispatcher", "[task]") {
+
+        GIVEN ("a sync dispatcher") {
+            sync_dispatcher dispatcher;
+
+            WHEN ("a task is spawned") {
+                auto future = spawn (dispatcher, add_chain (dispatcher));
+
+                THEN ("it should only progress while dispatching") {
+                    REQUIRE (future.wait_for (0s) == std::future_status::timeout);
+                    REQUIRE (dispatcher.pending () == 1);
+
+                    REQUIRE (dispatch_until_ready (dispatcher, future));
+                    REQUIRE (future.get () == 6);
+                }
+            }
+
+            WHEN ("a task throws") {
+                auto future = spawn (dispatcher, fail (dispatcher));
+
+                THEN ("the exception should reach the future") {
+                    REQUIRE (dispatch_until_ready (dispatcher, future));
+                    REQUIRE_THROWS_AS (future.get (), std::runtime_error);
+                }
+            }
+
+            WHEN ("a task is scheduled") {
+                auto future = spawn (dispatcher, resumed_thread (dispatcher));
+
+                THEN ("it should resume on the dispatching thread") {
+                    REQUIRE (dispatch_until_ready (dispatcher, future));
+                    REQUIRE (future.get () == std::this_thread::get_id ());
+                }
+            }
+        }
+    }
+
+    SCENARIO ("Coroutine tasks on an async dispatcher", "[task]") {
+
+        GIVEN ("an async dispatcher") {
+            async_dispatcher dispatcher { 4 };
+
+            WHEN ("a task is scheduled") {
+                auto future = spawn (dispatcher, resumed_thread (dispatcher));
+
+                THEN ("it should resume on a worker thread") {
+                    REQUIRE (future.get () != std::this_thread::get_id ());
+                }
+            }
+
+            WHEN ("many tasks are spawned") {
+                std::size_t const TASK_COUNT = 1000;
+                std::vector < std::future < int > > futures;
+
+                for (std::size_t i = 0; i < TASK_COUNT; ++i) {
+                    futures.push_back (spawn (dispatcher, add_chain (dispatcher)));
+                }
+
+                THEN ("every task should complete with its result") {
+                    for (auto & future : futures) {
+                        REQUIRE (future.get () == 6);
+                    }
+                }
+            }
+
+            WHEN ("a task throws") {
+                auto future = spawn (dispatcher, fail (dispatcher));
+
+                THEN ("the exception should reach the future") {
+                    REQUIRE_THROWS_AS (future.get (), std::runtime_error);
+                }
+            }
+        }
+    }
+
+    SCENARIO ("Coroutine tasks on a strand", "[task][strand]") {
+
+        GIVEN ("a strand over an async dispatcher") {
+            async_dispatcher dispatcher { 4 };
+            strand serial { dispatcher };
+
+            WHEN ("many tasks resume on the strand") {
+                std::size_t const TASK_COUNT = 1000;
+                std::vector < std::future < bool > > futures;
+                int counter { 0 };
+
+                for (std::size_t i = 0; i < TASK_COUNT; ++i) {
+                    futures.push_back (spawn (dispatcher, count_on_strand (serial, counter)));
+                }
+
+                THEN ("they should run one at a time on the strand") {
+                    for (auto & future : futures) {
+                        REQUIRE (future.get ());
+                    }
+
+                    REQUIRE (counter == static_cast < int > (TASK_COUNT));
+
+                    // the last drain may still be returning, the strand must outlive it
+                    dispatcher.join ();
+                }
+            }
+        }
+    }
+
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/dispatcher.hpp>
+#include <las/task_group.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+namespace las::test {
+
+    SCENARIO ("Task group wait", "[task_group]") {
+
+        GIVEN ("an async dispatcher and a task group") {
+            async_dispatcher    dispatcher { 4, async_dispatch_mode::work_stealing };
+            task_group          group { dispatcher };
+
+            std::atomic_size_t  count { 0 };
+            std::size_t const   TASK_COUNT = 1000;
+
+            WHEN ("many tasks are run") {
+                for (std::size_t i = 0; i < TASK_COUNT; ++i) {
+                    group.run ([&count] { ++count; });
+                }
+
+                group.wait ();
+
+                THEN ("every task should be executed before wait returns") {
+                    REQUIRE (count == TASK_COUNT);
+                    REQUIRE (group.pending () == 0);
+                }
+            }
+        }
+
+        GIVEN ("a sync dispatcher and a task group") {
+            sync_dispatcher     dispatcher;
+            task_group          group { dispatcher };
+
+            std::size_t         count { 0 };
+
+            WHEN ("the group is waited for from a dispatched task") {
+                // queued ahead of the group's tasks, only the waiter can run them
+                dispatcher.post ([&group] { group.wait (); });
+
+                group.run ([&count] { ++count; });
+                group.run ([&count] { ++count; });
+
+                REQUIRE (group.pending () == 2);
+
+                dispatcher.dispatch ();
+
+                THEN ("the dispatching thread should execute them while waiting") {
+                    REQUIRE (count == 2);
+                    REQUIRE (group.pending () == 0);
+                    REQUIRE (dispatcher.is_done ());
+                }
+            }
+
+            WHEN ("the group is waited for from another thread") {
+                std::thread::id executed_on {};
+                std::atomic_bool waited { false };
+
+                group.run ([&executed_on] { executed_on = std::this_thread::get_id (); });
+
+                std::thread waiter ([&] {
+                    group.wait ();
+                    waited = true;
+                });
+
+                std::this_thread::sleep_for (std::chrono::milliseconds (10));
+                REQUIRE_FALSE (waited);
+
+                dispatcher.dispatch ();
+                waiter.join ();
+
+                THEN ("the tasks should only execute on the dispatching thread") {
+                    REQUIRE (executed_on == std::this_thread::get_id ());
+                    REQUIRE (waited);
+                }
+            }
+        }
+    }
+
+    SCENARIO ("Task group on a rejecting dispatcher", "[task_group]") {
+
+        GIVEN ("a full bounded dispatcher rejecting tasks") {
+            async_dispatcher_options options;
+
+            options.thread_count = 1;
+            options.queue_capacity = 1;
+            options.overflow = queue_overflow::reject;
+
+            async_dispatcher    dispatcher { options };
+            std::atomic_bool    started { false };
+            std::atomic_bool    released { false };
+            std::atomic_size_t  count { 0 };
+
+            // hold the only worker
+            dispatcher.post ([&] {
+                started = true;
+
+                while (!released) {
+                    std::this_thread::yield ();
+                }
+            });
+
+            while (!started) {
+                std::this_thread::yield ();
+            }
+
+            task_group group { dispatcher };
+            group.run ([&count] { ++count; });
+
+            WHEN ("a task is rejected") {
+                REQUIRE_THROWS_AS (group.run ([&count] { ++count; }), std::system_error);
+
+                THEN ("it should not be waited for") {
+                    REQUIRE (group.pending () == 1);
+
+                    released = true;
+                    group.wait ();
+
+                    REQUIRE (count == 1);
+                    REQUIRE (group.pending () == 0);
+                }
+            }
+        }
+    }
+
+    SCENARIO ("Task group cancel and exceptions", "[task_group]") {
+
+        GIVEN ("a sync dispatcher and a task group") {
+            sync_dispatcher     dispatcher;
+            task_group          group { dispatcher };
+
+            std::size_t         count { 0 };
+
+            WHEN ("the group is cancelled before the tasks start") {
+                group.run ([&count] { ++count; });
+                group.run ([&count] { ++count; });
+
+                group.cancel ();
+                dispatcher.dispatch ();
+                group.wait ();
+
+                THEN ("no task should be executed") {
+                    REQUIRE (count == 0);
+                    REQUIRE (group.pending () == 0);
+                }
+
+                AND_THEN ("the group should be reusable after wait") {
+                    REQUIRE_FALSE (group.is_cancelled ());
+
+                    group.run ([&count] { ++count; });
+                    dispatcher.dispatch ();
+                    group.wait ();
+
+                    REQUIRE (count == 1);
+                }
+            }
+
+            WHEN ("a task throws") {
+                group.run ([] { throw std::runtime_error ("task failure"); });
+                group.run ([&count] { ++count; });
+
+                THEN ("wait should rethrow and the remaining tasks should be skipped") {
+                    dispatcher.dispatch ();
+
+                    REQUIRE_THROWS_AS (group.wait (), std::runtime_error);
+                    REQUIRE (count == 0);
+                    REQUIRE (group.pending () == 0);
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,165 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/dispatcher.hpp>
+#include <las/timer_wheel.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace las::test {
+
+    using namespace std::chrono_literals;
+
+    namespace {
+
+        /// dispatch a sync dispatcher until a condition is met or a timeout expires
+        template < typename predicate_t >
+        bool dispatch_until (sync_dispatcher & dispatcher, predicate_t && predicate, std::chrono::milliseconds timeout = 2s) {
+            auto const DEADLINE = std::chrono::steady_clock::now () + timeout;
+
+            while (!predicate ()) {
+                if (std::chrono::steady_clock::now () > DEADLINE) {
+                    return false;
+                }
+
+                dispatcher.dispatch ();
+                std::this_thread::sleep_for (1ms);
+            }
+
+            return true;
+        }
+
+    }
+
+    SCENARIO ("Timer wheel delayed tasks", "[timer_wheel]") {
+
+        GIVEN ("a timer wheel and a sync dispatcher") {
+            sync_dispatcher     dispatcher;
+            timer_wheel         timers;
+
+            std::vector < int > executed;
+
+            WHEN ("delayed tasks are scheduled out of order") {
+                timers.schedule_after (dispatcher, 30ms, [&executed] { executed.push_back (30); });
+                timers.schedule_after (dispatcher, 10ms, [&executed] { executed.push_back (10); });
+                timers.schedule_after (dispatcher, 20ms, [&executed] { executed.push_back (20); });
+
+                REQUIRE (timers.size () == 3);
+
+                THEN ("tasks should be posted in expiry order") {
+                    REQUIRE (dispatch_until (dispatcher, [&executed] { return executed.size () == 3; }));
+                    REQUIRE (executed == std::vector < int > { 10, 20, 30 });
+                    REQUIRE (timers.size () == 0);
+                }
+            }
+
+            WHEN ("a delay beyond the first wheel level is scheduled") {
+                auto const START = std::chrono::steady_clock::now ();
+                auto const DELAY = 150ms;
+
+                timers.schedule_after (dispatcher, DELAY, [&executed] { executed.push_back (1); });
+
+                THEN ("the task should be cascaded and posted after the delay") {
+                    REQUIRE (dispatch_until (dispatcher, [&executed] { return !executed.empty (); }));
+                    REQUIRE (std::chrono::steady_clock::now () - START >= DELAY);
+                }
+            }
+
+            WHEN ("a delayed task is cancelled") {
+                auto const ID = timers.schedule_after (dispatcher, 20ms, [&executed] { executed.push_back (1); });
+
+                REQUIRE (ID);
+                REQUIRE (timers.cancel (ID));
+
+                THEN ("the task should never be posted") {
+                    REQUIRE_FALSE (timers.cancel (ID));
+                    REQUIRE (timers.size () == 0);
+
+                    std::this_thread::sleep_for (40ms);
+                    dispatcher.dispatch ();
+
+                    REQUIRE (executed.empty ());
+                }
+            }
+        }
+    }
+
+    SCENARIO ("Timer wheel periodic tasks", "[timer_wheel]") {
+
+        GIVEN ("a timer wheel and a sync dispatcher") {
+            sync_dispatcher     dispatcher;
+            timer_wheel         timers;
+
+            std::size_t         count { 0 };
+
+            WHEN ("a periodic task is scheduled") {
+                auto const ID = timers.schedule_every (dispatcher, 2ms, [&count] { ++count; });
+
+                THEN ("the task should be posted repeatedly until cancelled") {
+                    REQUIRE (dispatch_until (dispatcher, [&count] { return count >= 5; }));
+                    REQUIRE (timers.cancel (ID));
+
+                    dispatcher.dispatch ();
+                    auto const FINAL_COUNT = count;
+
+                    std::this_thread::sleep_for (20ms);
+                    dispatcher.dispatch ();
+
+                    REQUIRE (count == FINAL_COUNT);
+                }
+            }
+        }
+    }
+
+    TEST_CASE ("Timer wheel many timers", "[timer_wheel]") {
+        async_dispatcher    dispatcher { 2 };
+        timer_wheel         timers;
+
+        std::size_t const   TIMER_COUNT = 2000;
+        std::atomic_size_t  fired { 0 };
+
+        std::vector < timer_id > ids;
+
+        for (std::size_t i = 0; i < TIMER_COUNT; ++i) {
+            ids.push_back (timers.schedule_after (dispatcher, std::chrono::milliseconds { 1 + i % 200 }, [&fired] { ++fired; }));
+        }
+
+        // cancel every other timer
+        std::size_t cancelled { 0 };
+
+        for (std::size_t i = 0; i < TIMER_COUNT; i += 2) {
+            if (timers.cancel (ids [i])) {
+                ++cancelled;
+            }
+        }
+
+        auto const DEADLINE = std::chrono::steady_clock::now () + 2s;
+
+        while (fired.load () < TIMER_COUNT - cancelled && std::chrono::steady_clock::now () < DEADLINE) {
+            std::this_thread::sleep_for (1ms);
+        }
+
+        REQUIRE (fired == TIMER_COUNT - cancelled);
+        REQUIRE (timers.size () == 0);
+    }
+
+    TEST_CASE ("Timer wheel delay beyond the wheel span", "[timer_wheel]") {
+        sync_dispatcher     dispatcher;
+
+        // the wheel spans 64^4 ticks, about 168ms at this resolution
+        timer_wheel         timers { 10ns };
+        bool                fired { false };
+
+        auto const START = std::chrono::steady_clock::now ();
+        auto const DELAY = 250ms;
+
+        timers.schedule_after (dispatcher, DELAY, [&fired] { fired = true; });
+
+        REQUIRE (dispatch_until (dispatcher, [&fired] { return fired; }));
+        REQUIRE (std::chrono::steady_clock::now () - START >= DELAY);
+    }
+
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch_all.hpp>
+
+#include <las/work_stealing_deque.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace las::test {
+
+    SCENARIO ("work_stealing_deque single thread access", "[work_stealing_deque]") {
+
+        GIVEN ("an empty work_stealing_deque") {
+            work_stealing_deque < int > victim { 4 };
+
+            THEN ("pop and steal should find nothing") {
+                REQUIRE (victim.empty ());
+                REQUIRE_FALSE (victim.pop ().has_value ());
+                REQUIRE_FALSE (victim.steal ().has_value ());
+            }
+
+            WHEN ("values are pushed") {
+                victim.push (1);
+                victim.push (2);
+                victim.push (3);
+
+                THEN ("pop should return the most recent value") {
+                    REQUIRE (victim.size () == 3);
+                    REQUIRE (victim.pop () == 3);
+                    REQUIRE (victim.pop () == 2);
+                    REQUIRE (victim.pop () == 1);
+                    REQUIRE_FALSE (victim.pop ().has_value ());
+                }
+
+                AND_THEN ("steal should return the oldest value") {
+                    REQUIRE (victim.steal () == 1);
+                    REQUIRE (victim.steal () == 2);
+                    REQUIRE (victim.steal () == 3);
+                    REQUIRE_FALSE (victim.steal ().has_value ());
+                }
+
+                AND_THEN ("pop and steal should meet in the middle") {
+                    REQUIRE (victim.steal () == 1);
+                    REQUIRE (victim.pop () == 3);
+                    REQUIRE (victim.steal () == 2);
+                    REQUIRE (victim.empty ());
+                }
+            }
+
+            WHEN ("more values than capacity are pushed") {
+                int const COUNT = 100;
+
+                for (int i = 0; i < COUNT; ++i) {
+                    victim.push (i);
+                }
+
+                THEN ("the deque should grow and keep every value in order") {
+                    REQUIRE (victim.capacity () >= COUNT);
+                    REQUIRE (victim.size () == COUNT);
+
+                    for (int i = 0; i < COUNT; ++i) {
+                        REQUIRE (victim.steal () == i);
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_CASE ("work_stealing_deque concurrent steal", "[work_stealing_deque]") {
+        std::size_t const   THIEF_COUNT = 3;
+        int const           ITEM_COUNT = 100000;
+
+        work_stealing_deque < int > victim { 16 };
+        std::vector < std::vector < int > > stolen (THIEF_COUNT);
+        std::vector < int > popped;
+
+        std::atomic_bool done { false };
+        std::vector < std::thread > thieves;
+
+        for (std::size_t i = 0; i < THIEF_COUNT; ++i) {
+            thieves.emplace_back ([&, i] {
+                while (!done.load () || !victim.empty ()) {
+                    if (auto value = victim.steal ()) {
+                        stolen [i].push_back (*value);
+                    }
+                }
+            });
+        }
+
+        for (int i = 0; i < ITEM_COUNT; ++i) {
+            victim.push (i);
+
+            // owner keeps consuming part of its own work
+            if (i % 3 == 0) {
+                if (auto value = victim.pop ()) {
+                    popped.push_back (*value);
+                }
+            }
+        }
+
+        done = true;
+
+        for (auto & thief : thieves) {
+            thief.join ();
+        }
+
+        // every value should have been taken exactly once
+        std::vector < int > taken { popped };
+
+        for (auto const & thief_values : stolen) {
+            taken.insert (taken.end (), thief_values.begin (), thief_values.end ());
+        }
+
+        std::sort (taken.begin (), taken.end ());
+
+        std::vector < int > expected (ITEM_COUNT);
+        std::iota (expected.begin (), expected.end (), 0);
+
+        REQUIRE (taken == expected);
+    }
+
+}